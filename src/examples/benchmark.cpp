@@ -6,41 +6,54 @@
         (See accompanying file LICENSE_1_0.txt or copy at
         http://www.boost.org/LICENSE_1_0.txt)
 */
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <sstream>
+#include <string>
+#include <vector>
 
+#include "generic_format/datastructures/dense_reversible_multimap.hpp"
 #include "generic_format/dsl.hpp"
+#include "generic_format/lookup/lookup_table.hpp"
 #include "generic_format/generic_format.hpp"
+#include "generic_format/mapping/mapping.hpp"
+#include "generic_format/targets/bounded_memory.hpp"
 #include "generic_format/targets/unbounded_memory.hpp"
+#include "generic_format/targets/vector_buffer.hpp"
 #include "packet.hpp"
 
 using namespace std;
 using namespace demo;
 using namespace generic_format::primitives;
 using namespace generic_format::dsl;
+using namespace generic_format::targets::bounded_memory;
 using namespace generic_format::targets::unbounded_memory;
+using namespace generic_format::targets::vector_buffer;
 
 static constexpr auto packet_format = adapt_struct(GENERIC_FORMAT_MEMBER(Packet, source, uint32_le),
                                                    GENERIC_FORMAT_MEMBER(Packet, target, uint32_le),
                                                    GENERIC_FORMAT_MEMBER(Packet, port, uint16_le));
 
-int main() {
-    constexpr unsigned int number_of_iterations = 100000;
-    constexpr unsigned int number_of_packets    = 10000;
-    Packet                 packet{};
-    auto                   start = chrono::high_resolution_clock::now();
+static constexpr unsigned int number_of_iterations = 100000;
+static constexpr unsigned int number_of_packets    = 10000;
+
+static constexpr auto        size_container         = decltype(packet_format)::size;
+static constexpr std::size_t serialized_packet_size = size_container.size();
+
+using buffer_type = std::array<std::uint8_t, number_of_packets * serialized_packet_size>;
 
-    static constexpr auto                                                size_container         = decltype(packet_format)::size;
-    static constexpr std::size_t                                         serialized_packet_size = size_container.size();
-    std::array<std::uint8_t, number_of_packets * serialized_packet_size> buffer{};
-    void*                                                                data = static_cast<void*>(buffer.data());
+/// Writes and reads all packets via the writers and readers created by the given factories, and prints the elapsed time.
+template <class WriterFactory, class ReaderFactory>
+static void run_benchmark(const char* name, WriterFactory create_writer, ReaderFactory create_reader) {
+    Packet packet{};
+    auto   start = chrono::high_resolution_clock::now();
 
     int tmp = 0;
     for (unsigned int i = 0; i < number_of_iterations; ++i) {
-        auto writer = unbounded_memory_target::writer{data};
-        auto reader = unbounded_memory_target::reader{data};
+        auto writer = create_writer();
         for (std::uint16_t p = 0; p < number_of_packets; ++p) {
             packet.source = i;
             packet.target = p;
@@ -49,6 +62,7 @@ int main() {
             // layer?
             writer(packet, packet_format);
         }
+        auto reader = create_reader();
         for (unsigned int p = 0; p < number_of_packets; ++p) {
             reader(packet, packet_format);
             tmp += int(packet.source) + int(packet.target) + packet.port;
@@ -57,6 +71,148 @@ int main() {
     }
     auto stop         = chrono::high_resolution_clock::now();
     auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-    std::cout << "computed " << tmp << std::endl;
-    std::cout << microseconds.count() << std::endl;
+    std::cout << name << ": computed " << tmp << std::endl;
+    std::cout << name << ": " << microseconds.count() << std::endl;
+}
+
+/// Decodes a vector of integers from memory, and prints the throughput in bytes of input per second.
+template <class Format>
+static void run_varint_benchmark(const char* name, const std::vector<std::uint32_t>& values, Format format) {
+    static constexpr unsigned int number_of_decodings = 1000;
+
+    std::vector<std::byte> bytes;
+    {
+        auto writer = vector_buffer_target::writer{&bytes};
+        writer(values, format);
+    }
+
+    std::vector<std::uint32_t> decoded;
+    std::uint64_t              tmp   = 0;
+    auto                       start = chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < number_of_decodings; ++i) {
+        auto reader = bounded_memory_target::reader{bytes.data(), bytes.size()};
+        reader(decoded, format);
+        tmp += decoded[i % decoded.size()];
+    }
+    auto stop    = chrono::high_resolution_clock::now();
+    auto seconds = std::chrono::duration<double>(stop - start).count();
+    assert(decoded == values);
+    std::cout << name << ": computed " << tmp << std::endl;
+    std::cout << name << ": " << static_cast<double>(bytes.size()) * number_of_decodings / seconds / 1e9 << " GB/s" << std::endl;
+}
+
+/// Values whose LEB128 encodings take 1 to `max_length` bytes, in random order.
+static std::vector<std::uint32_t> varint_values(std::size_t count, unsigned max_length) {
+    std::vector<std::uint32_t> result(count);
+    std::uint64_t              state = 7;
+    for (auto& v : result) {
+        state       = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        auto length = static_cast<unsigned>((state >> 33) % max_length) + 1;
+        auto bits   = std::min(7 * length, 32u);
+        v           = static_cast<std::uint32_t>(state >> 7) & static_cast<std::uint32_t>((std::uint64_t{1} << bits) - 1);
+        v |= length > 1 ? std::uint32_t{1} << (7 * (length - 1)) : 0; // forces the length
+    }
+    return result;
+}
+
+/// Reads a multimap and rebuilds its reverse rows with the given format, and prints the elapsed time.
+template <class Format>
+static void run_reverse_benchmark(const char* name, const std::vector<std::byte>& bytes, Format format) {
+    using generic_format::datastructures::dense_reversible_multimap;
+
+    static constexpr unsigned int number_of_readings = 10;
+    std::size_t                   tmp                = 0;
+    auto                          start              = chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < number_of_readings; ++i) {
+        dense_reversible_multimap<std::uint32_t> multimap;
+        auto                                     reader = vector_buffer_target::reader{&bytes};
+        reader(multimap, format);
+        tmp += multimap.reverse()[i].size();
+    }
+    auto stop         = chrono::high_resolution_clock::now();
+    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+    std::cout << name << ": computed " << tmp << std::endl;
+    std::cout << name << ": " << microseconds.count() << std::endl;
+}
+
+/// A random graph whose nodes have 16 edges each.
+static std::vector<std::byte> reverse_benchmark_data(std::uint32_t number_of_nodes) {
+    generic_format::datastructures::dense_reversible_multimap<std::uint32_t> graph;
+    std::uint64_t                                                            state = 7;
+    for (std::uint32_t node = 0; node < number_of_nodes; ++node) {
+        for (int i = 0; i < 16; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            graph.put(node, static_cast<std::uint32_t>((state >> 33) % number_of_nodes));
+        }
+    }
+    std::vector<std::byte> bytes;
+    auto                   writer = vector_buffer_target::writer{&bytes};
+    writer(graph, dense_reversible_multimap_format(uint32_le));
+    return bytes;
+}
+
+/// Merges builders of distinct strings into a lookup table, and prints the elapsed time.
+template <std::size_t shards>
+static void run_merge_benchmark(const char* name, unsigned threads) {
+    using builder_type = generic_format::lookup::lookup_table_builder<std::uint32_t, std::string>;
+
+    static constexpr std::uint32_t number_of_builders = 16;
+    static constexpr std::uint32_t values_per_builder = 1 << 16;
+    std::vector<builder_type>      builders;
+    for (std::uint32_t b = 0; b < number_of_builders; ++b) {
+        builders.emplace_back(b * values_per_builder, values_per_builder);
+        for (std::uint32_t i = 0; i < values_per_builder; ++i)
+            builders.back().push_back("value " + std::to_string(b * values_per_builder + i));
+    }
+
+    auto start = chrono::high_resolution_clock::now();
+    generic_format::lookup::lookup_table<std::uint32_t, std::string, true, shards> table(builders.begin(), builders.end(), threads);
+    auto stop         = chrono::high_resolution_clock::now();
+    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+    std::cout << name << ": computed " << table.lookup_by_value("value 12345") << std::endl;
+    std::cout << name << ": " << microseconds.count() << std::endl;
+}
+
+int main() {
+    static buffer_type buffer{};
+    void*              data = static_cast<void*>(buffer.data());
+
+    run_benchmark(
+        "unbounded_memory", [&] { return unbounded_memory_target::writer{data}; }, [&] { return unbounded_memory_target::reader{data}; });
+    run_benchmark(
+        "bounded_memory",
+        [&] { return bounded_memory_target::writer{data, buffer.size()}; },
+        [&] { return bounded_memory_target::reader{data, buffer.size()}; });
+
+    std::vector<std::byte> bytes;
+    run_benchmark(
+        "vector_buffer",
+        [&] {
+            bytes.clear(); // keeps the capacity
+            return vector_buffer_target::writer{&bytes};
+        },
+        [&] { return vector_buffer_target::reader{&bytes}; });
+
+    using varint_container_format = generic_format::ast::infer_format<std::remove_cv_t<decltype(container_format(uint32_le, varint_u32))>,
+                                                                      std::vector<std::uint32_t>>::type;
+    run_varint_benchmark("varint (1 byte)", varint_values(1 << 20, 1), varint_container_format());
+    run_varint_benchmark("varint (1-2 bytes)", varint_values(1 << 20, 2), varint_container_format());
+    run_varint_benchmark("varint (1-3 bytes)", varint_values(1 << 20, 3), varint_container_format());
+    run_varint_benchmark("varint (1-5 bytes)", varint_values(1 << 20, 5), varint_container_format());
+    run_varint_benchmark("stream vbyte (1 byte)", varint_values(1 << 20, 1), stream_vbyte_format(uint32_le));
+    run_varint_benchmark("stream vbyte (1-2 bytes)", varint_values(1 << 20, 2), stream_vbyte_format(uint32_le));
+    run_varint_benchmark("stream vbyte (1-3 bytes)", varint_values(1 << 20, 3), stream_vbyte_format(uint32_le));
+    run_varint_benchmark("stream vbyte (1-5 bytes)", varint_values(1 << 20, 5), stream_vbyte_format(uint32_le));
+
+    // the work does not grow with the number of threads, so the time only drops on machines with several cores
+    auto graph = reverse_benchmark_data(1 << 18);
+    run_reverse_benchmark("reverse rows (1 thread)", graph, dense_reversible_multimap_format(uint32_le));
+    run_reverse_benchmark("reverse rows (4 threads)", graph, parallel_dense_reversible_multimap_format<4>(uint32_le));
+    run_reverse_benchmark("reverse rows (all threads)", graph, parallel_dense_reversible_multimap_format<0>(uint32_le));
+
+    // only the copy of the values is parallel with a single shard, the map is filled in parallel with several shards
+    run_merge_benchmark<1>("merge (1 shard, 1 thread)", 1);
+    run_merge_benchmark<1>("merge (1 shard, all threads)", 0);
+    run_merge_benchmark<16>("merge (16 shards, 1 thread)", 1);
+    run_merge_benchmark<16>("merge (16 shards, all threads)", 0);
 }
@@ -7,14 +7,21 @@
         http://www.boost.org/LICENSE_1_0.txt)
 */
 #include <fstream>
+#include <string>
 #include <vector>
-#include <unordered_map>
-#include "packet.hpp"
 
-#include "generic_format/generic_format.hpp"
-#include "generic_format/targets/iostream.hpp"
 #include "generic_format/dsl.hpp"
+#include "generic_format/generic_format.hpp"
 #include "generic_format/lookup/lookup.hpp"
+#include "generic_format/mapping/struct_adaptor.hpp"
+#include "generic_format/targets/iostream.hpp"
+
+/// A document of a commit-log segment, whose strings are replaced by ids of dictionaries.
+struct Document {
+    std::uint8_t  source_type{};
+    std::uint16_t language{};
+    std::int64_t  publication_timestamp{};
+};
 
 int main() {
     using namespace generic_format::primitives;
@@ -23,31 +30,61 @@ int main() {
     using namespace generic_format::lookup;
     using namespace std;
 
-
     static constexpr auto source_type = lookup_type(uint8_le, string_format(uint8_le));
-    static constexpr auto language = lookup_type(uint16_le, string_format(uint8_le));
-    static constexpr auto country = lookup_type(uint16_le, string_format(uint8_le));
-    static constexpr auto root_url = lookup_type(uint16_le, string_format(uint16_le));
-    static constexpr auto publication_timestamp = int64_le;
-    static constexpr auto indexation_timestamp = int64_le;
-    static constexpr auto page_token = int64_le; // from API // TODO which stream if there are several?
-
-    static constexpr auto f = lookup_table_format(source_type);
-
-    // TODO implement via grouping?
-//    static constexpr auto page_size_ref = ref(GENERIC_FORMAT_PLACEHOLDER(__, 0), uint32_le);
-//    static constexpr auto commitlog_segment_format =
-//            uint32_le // timestamp
-//            << uint32_le // token to get this page via API
-//            << page_size_ref
-//            << repeated(page_size_ref, // documents from page
-//                string_format(uint8_le) // source_type
-//                << string_format(uint8_le) // language code
-//                << string_format(uint8_le) // country code
-//                << string_format(uint16_le) // root url
-//                << string_format(uint32_le)) // publication date
-
-               // TODO group and sort
-    //static constexpr auto data_format =
+    static constexpr auto language    = lookup_type(uint16_le, string_format(uint8_le));
+
+    static constexpr auto document_format = adapt_struct(GENERIC_FORMAT_MEMBER(Document, source_type, uint8_le),
+                                                         GENERIC_FORMAT_MEMBER(Document, language, uint16_le),
+                                                         GENERIC_FORMAT_MEMBER(Document, publication_timestamp, int64_le));
+    static constexpr auto documents_format
+        = generic_format::ast::infer_format<decltype(container_format(uint32_le, document_format)), vector<Document>>::type();
+
+    // each segment carries the dictionary entries which have been created since the previous segment
+    static constexpr auto source_types_format = generic_format::dsl::lookup_table_delta_format(source_type);
+    static constexpr auto languages_format    = generic_format::dsl::lookup_table_delta_format(language);
+
+    using source_type_table = decltype(source_type)::table_type;
+    using language_table    = decltype(language)::table_type;
+
+    const vector<vector<pair<string, string>>> segments{{{"news", "en"}, {"blog", "en"}, {"news", "fr"}},
+                                                        {{"news", "de"}, {"forum", "en"}},
+                                                        {{"blog", "fr"}}};
+    string file_name{"datestreams.out"};
+    {
+        source_type_table                     source_types;
+        language_table                        languages;
+        lookup_table_delta<source_type_table> source_types_delta{source_types};
+        lookup_table_delta<language_table>    languages_delta{languages};
+
+        ofstream os{file_name, ios_base::out | ios_base::binary};
+        auto     writer    = iostream_target::writer{&os};
+        int64_t  timestamp = 1400000000;
+        for (const auto& segment : segments) {
+            vector<Document> documents;
+            for (const auto& [source, lang] : segment)
+                documents.push_back({source_types.lookup_by_value(source), languages.lookup_by_value(lang), timestamp++});
+            writer(source_types_delta, source_types_format);
+            writer(languages_delta, languages_format);
+            writer(documents, documents_format);
+        }
+    }
+    {
+        source_type_table                     source_types;
+        language_table                        languages;
+        lookup_table_delta<source_type_table> source_types_delta{source_types};
+        lookup_table_delta<language_table>    languages_delta{languages};
 
+        ifstream is{file_name, ios_base::in | ios_base::binary};
+        auto     reader = iostream_target::reader{&is};
+        for (std::size_t i = 0; i < segments.size(); ++i) {
+            vector<Document> documents;
+            reader(source_types_delta, source_types_format);
+            reader(languages_delta, languages_format);
+            reader(documents, documents_format);
+            cout << "segment " << i << " (" << source_types.size() << " source types, " << languages.size() << " languages):" << endl;
+            for (const auto& document : documents)
+                cout << "  " << source_types.lookup_by_id(document.source_type) << " " << languages.lookup_by_id(document.language) << " "
+                     << document.publication_timestamp << endl;
+        }
+    }
 }
@@ -0,0 +1,108 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "generic_format/dsl.hpp"
+#include "generic_format/generic_format.hpp"
+#include "generic_format/targets/file_descriptor.hpp"
+#include "generic_format/targets/iostream.hpp"
+#include "generic_format/targets/memory_mapped.hpp"
+#include "packet.hpp"
+
+using namespace std;
+using namespace demo;
+using namespace generic_format::primitives;
+using namespace generic_format::dsl;
+using namespace generic_format::targets::file_descriptor;
+using namespace generic_format::targets::iostream;
+using namespace generic_format::targets::memory_mapped;
+
+static constexpr auto packet_format = adapt_struct(GENERIC_FORMAT_MEMBER(Packet, source, uint32_le),
+                                                   GENERIC_FORMAT_MEMBER(Packet, target, uint32_le),
+                                                   GENERIC_FORMAT_MEMBER(Packet, port, uint16_le));
+
+static constexpr unsigned int number_of_packets = 10000000;
+
+/// Writes all packets via the writer, reads them back via the reader, and prints the elapsed times.
+template <class WriterFactory, class ReaderFactory>
+static void run_benchmark(const char* name, WriterFactory create_writer, ReaderFactory create_reader) {
+    Packet packet{};
+    auto   start = chrono::high_resolution_clock::now();
+    {
+        auto writer = create_writer();
+        for (unsigned int p = 0; p < number_of_packets; ++p) {
+            packet.source = p;
+            packet.target = p + 1;
+            packet.port   = static_cast<std::uint16_t>(p);
+            writer(packet, packet_format);
+        }
+    }
+    auto middle = chrono::high_resolution_clock::now();
+    int  tmp    = 0;
+    {
+        auto reader = create_reader();
+        for (unsigned int p = 0; p < number_of_packets; ++p) {
+            reader(packet, packet_format);
+            tmp += int(packet.source) + int(packet.target) + packet.port;
+            assert(packet.source == p);
+        }
+    }
+    auto stop = chrono::high_resolution_clock::now();
+    std::cout << name << ": computed " << tmp << std::endl;
+    std::cout << name << ": write " << chrono::duration_cast<chrono::microseconds>(middle - start).count() << std::endl;
+    std::cout << name << ": read " << chrono::duration_cast<chrono::microseconds>(stop - middle).count() << std::endl;
+}
+
+int main() {
+    const char* file_name = "file_benchmark.out";
+
+    {
+        ofstream os;
+        ifstream is;
+        run_benchmark(
+            "iostream",
+            [&] {
+                os.open(file_name, ios_base::out | ios_base::binary | ios_base::trunc);
+                return iostream_target::writer{&os};
+            },
+            [&] {
+                os.close();
+                is.open(file_name, ios_base::in | ios_base::binary);
+                return iostream_target::reader{&is};
+            });
+    }
+
+    {
+        int fd = -1;
+        run_benchmark(
+            "file_descriptor",
+            [&] {
+                fd = ::open(file_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+                return file_descriptor_target::writer{fd};
+            },
+            [&] {
+                ::lseek(fd, 0, SEEK_SET);
+                return file_descriptor_target::reader{fd};
+            });
+        ::close(fd);
+    }
+
+    run_benchmark(
+        "memory_mapped",
+        [&] { return mmap_target::writer{file_name}; },
+        [&] { return mmap_target::reader{file_name, mmap_reader_options{true, std::size_t{1} << 20}}; });
+
+    std::remove(file_name);
+}
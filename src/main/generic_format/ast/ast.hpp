@@ -8,11 +8,16 @@
 */
 #pragma once
 
+#include "generic_format/ast/delta_bitpacked.hpp"
 #include "generic_format/ast/inference.hpp"
+#include "generic_format/ast/measure.hpp"
 #include "generic_format/ast/raw.hpp"
 #include "generic_format/ast/reference.hpp"
 #include "generic_format/ast/sequence.hpp"
+#include "generic_format/ast/skip.hpp"
 #include "generic_format/ast/variable.hpp"
 #include "generic_format/ast/repeated.hpp"
+#include "generic_format/ast/stream_vbyte.hpp"
 #include "generic_format/ast/string.hpp"
+#include "generic_format/ast/varint.hpp"
 #include "generic_format/ast/versioned.hpp"
@@ -0,0 +1,112 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "generic_format/accessor/accessor.hpp"
+#include "generic_format/ast/base.hpp"
+#include "generic_format/ast/raw.hpp"
+#include "generic_format/ast/reference.hpp"
+
+namespace generic_format::ast {
+
+template <class NativeType, class Children>
+struct sequence;
+
+/** @brief Tells whether a format serializes a native type as a plain copy of the first F::size bytes of its memory representation.
+ *
+ * `value` is decided at compile-time, including the member offsets of adapted structs.
+ * @tparam F the format
+ * @tparam T the native type
+ */
+template <class F, class T, class Enable = void>
+struct bytewise : std::false_type { };
+
+/// Raw formats copy the bytes of the native type.
+template <class F, class T>
+requires(std::is_base_of<raw<T>, F>::value && !std::is_const<F>::value) struct bytewise<F, T> : std::true_type { };
+
+/// Const formats (e.g. via decltype of a constexpr format) behave like their non-const versions.
+template <class F, class T>
+requires std::is_const<F>::value struct bytewise<F, T> : bytewise<std::remove_const_t<F>, T> { };
+
+namespace detail {
+
+/** @brief Like offsetof, but for member pointers, and evaluated at compile-time.
+ *
+ * The member is located within a value-initialized object, by comparing its address to the addresses of the bytes of the object.
+ */
+template <class Class, class Type, Type Class::*Member>
+constexpr std::size_t member_offset() {
+    union storage {
+        unsigned char bytes[sizeof(Class)];
+        Class         object;
+        constexpr storage()
+            : object{} { }
+    };
+    storage s;
+    auto    member = static_cast<const void*>(&(s.object.*Member));
+    for (std::size_t i = 0; i < sizeof(Class); ++i)
+        if (static_cast<const void*>(&s.bytes[i]) == member)
+            return i;
+    return sizeof(Class);
+}
+
+/// Tells whether a child of a sequence maps a member of T bytewise, occupying exactly the size of the member.
+template <class Child, class T>
+struct bytewise_member : std::false_type { };
+
+template <class Class, class Type, Type Class::*Member, class F>
+struct bytewise_member<dereference<reference<formatted_accessor<accessor::member_ptr<Class, Type, Member>, F>>>, Class>
+    : std::integral_constant<bool, bytewise<F, Type>::value && F::size.size() == sizeof(Type)> {
+
+    static constexpr std::size_t size = sizeof(Type);
+
+    static constexpr std::size_t offset() {
+        return member_offset<Class, Type, Member>();
+    }
+};
+
+/** @brief True if all children map members of T bytewise, in memory order and without padding in-between.
+ *
+ * T needs to be trivially default constructible, such that its member offsets can be computed at compile-time.
+ */
+template <class T, class... Children>
+constexpr bool members_are_contiguous() {
+    if constexpr (std::is_trivially_copyable<T>::value && std::is_trivially_default_constructible<T>::value
+                  && (bytewise_member<Children, T>::value && ...)) {
+        std::size_t expected_offset = 0;
+        bool        result          = true;
+        ((result = result && bytewise_member<Children, T>::offset() == expected_offset, expected_offset += bytewise_member<Children, T>::size),
+         ...);
+        return result;
+    } else {
+        return false;
+    }
+}
+
+} // end namespace detail
+
+/// Sequences of members of a trivially copyable struct, declared in memory order without padding in-between.
+template <class T, class... Children>
+struct bytewise<sequence<T, format_list<Children...>>, T>
+    : std::integral_constant<bool, (sizeof...(Children) > 0) && detail::members_are_contiguous<T, Children...>()> { };
+
+/// True if F serializes T bytewise, and values of T can be copied back-to-back without gaps (e.g. for arrays).
+template <class F, class T>
+constexpr bool is_bytewise_array_element() {
+    if constexpr (bytewise<F, T>::value)
+        return std::remove_cv_t<F>::size.size() == sizeof(T);
+    else
+        return false;
+}
+
+} // end namespace generic_format::ast
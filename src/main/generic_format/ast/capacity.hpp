@@ -0,0 +1,121 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "generic_format/ast/base.hpp"
+
+namespace generic_format::ast {
+
+/** @brief Tests whether a raw reader/writer can check its capacity for a whole block at once.
+ *
+ * Such a raw reader/writer provides `checked_block(size, function)`, which verifies that `size` bytes are available,
+ * calls `function` with an unchecked raw reader/writer, and then advances by exactly `size` bytes.
+ */
+template <class Raw>
+concept CapacityChecked = requires(Raw& raw, std::size_t size) {
+    raw.checked_block(size, [](auto&) {});
+};
+
+/** @brief Tests whether a raw reader exposes contiguous storage.
+ *
+ * Such a raw reader provides `view(size)`, which checks that `size` bytes can be read, returns a pointer to them
+ * and advances by `size` bytes. The pointer remains valid as long as the underlying storage.
+ */
+template <class Raw>
+concept ContiguousRawReader = requires(Raw& raw, std::size_t size) {
+    { raw.view(size) } -> std::convertible_to<const void*>;
+};
+
+/** @brief Announces that the next `size` bytes will be read or written by `function`.
+ *
+ * Bounded raw readers/writers check their capacity once and hand an unchecked raw reader/writer to the function.
+ * All other raw readers/writers are passed through unchanged.
+ */
+template <class Raw, class Function>
+void with_capacity(Raw& raw, std::size_t size, Function&& function) {
+    if constexpr (CapacityChecked<Raw>)
+        raw.checked_block(size, std::forward<Function>(function));
+    else
+        function(raw);
+}
+
+/// Tests whether a raw reader can advance by `size` bytes without copying them, via `skip(size)`.
+template <class Raw>
+concept SkippingRawReader = requires(Raw& raw, std::size_t size) {
+    raw.skip(size);
+};
+
+/// Advances a raw reader by `size` bytes, preferably without copying them.
+template <class RawReader>
+void skip_bytes(RawReader& raw_reader, std::size_t size) {
+    if constexpr (SkippingRawReader<RawReader>) {
+        raw_reader.skip(size);
+    } else if constexpr (ContiguousRawReader<RawReader>) {
+        raw_reader.view(size);
+    } else {
+        unsigned char buffer[4096];
+        while (size > 0) {
+            auto n = std::min(size, sizeof(buffer));
+            raw_reader(static_cast<void*>(buffer), n);
+            size -= n;
+        }
+    }
+}
+
+/// @brief Size of a block of `count` elements, saturating on overflow such that any capacity check fails.
+template <typename Count>
+constexpr std::size_t block_size(Count count, std::size_t element_size) {
+    constexpr auto max = std::numeric_limits<std::size_t>::max();
+    if constexpr (std::is_signed<Count>::value)
+        if (count < 0)
+            return max;
+    if (element_size != 0 && static_cast<std::size_t>(count) > max / element_size)
+        return max;
+    return static_cast<std::size_t>(count) * element_size;
+}
+
+/// @brief True if the format has a size which is known at compile-time.
+template <class F>
+concept FixedSizeFormat = Format<F> && requires {
+    F::size;
+    requires F::size.is_fixed();
+};
+
+/** @brief Writes a value, checking the capacity only once if the format has a fixed size.
+ *
+ * The return value of the format (if any) is discarded.
+ */
+template <Format F, class RawWriter, class State, class T>
+void write_checked(RawWriter& raw_writer, State& state, const T& t) {
+    if constexpr (FixedSizeFormat<F>)
+        with_capacity(raw_writer, F::size.size(), [&](auto& w) { F().write(w, state, t); });
+    else
+        F().write(raw_writer, state, t);
+}
+
+/** @brief Reads a value, checking the capacity only once if the format has a fixed size.
+ *
+ * The return value of the format (if any) is discarded.
+ */
+template <Format F, class RawReader, class State, class T>
+void read_checked(RawReader& raw_reader, State& state, T& t) {
+    if constexpr (FixedSizeFormat<F>)
+        with_capacity(raw_reader, F::size.size(), [&](auto& r) { F().read(r, state, t); });
+    else
+        F().read(raw_reader, state, t);
+}
+
+} // end namespace generic_format::ast
@@ -0,0 +1,192 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "generic_format/ast/base.hpp"
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/ast/skip.hpp"
+#include "generic_format/ast/raw.hpp"
+#include "generic_format/ast/varint.hpp"
+#include "generic_format/bitpacking.hpp"
+#include "generic_format/byteswap.hpp"
+#include "generic_format/exceptions.hpp"
+
+namespace generic_format::ast {
+
+/** @brief Encodes a vector of 32-bit integers, which is ideally sorted, by delta encoding and bit packing.
+ *
+ * The length is followed by blocks of 128 values, and the remaining values.
+ * Each block stores the deltas to the values 4 positions before, as a frame of reference (the minimal delta, 4 bytes),
+ * a bit width (1 byte), and the differences to the frame of reference, bit-packed with that width
+ * (see generic_format::detail::bitpacked_block). The remaining values are stored as LEB128 deltas to their predecessor.
+ *
+ * Any vector can be encoded, since deltas wrap around, but only sorted vectors are compressed well.
+ */
+template <IntegralFormat LengthFormat>
+struct delta_bitpacked : base<format_list<LengthFormat>> {
+    using length_format        = LengthFormat;
+    using native_length_type   = typename length_format::native_type;
+    using value_type           = std::uint32_t;
+    using native_type          = std::vector<value_type>;
+    static constexpr auto size = dynamic_size();
+
+    template <class RawWriter, class State>
+    void write(RawWriter& raw_writer, State& state, const native_type& t) const {
+        if (t.size() > std::numeric_limits<native_length_type>::max())
+            throw serialization_exception();
+        length_format().write(raw_writer, state, static_cast<native_length_type>(t.size()));
+        const auto    blocks = t.size() / block::size;
+        value_type    deltas[block::size];
+        value_type    words[block::words(block::max_width)];
+        for (std::size_t b = 0; b < blocks; ++b) {
+            const auto [reference, width] = block_deltas(t, b, deltas);
+            generic_format::detail::bitpack_128(deltas, width, words);
+            convert_little_endian(words, block::words(width));
+            reference_format().write(raw_writer, state, reference);
+            raw_writer(static_cast<std::uint8_t>(width));
+            raw_writer(static_cast<const void*>(words), block::words(width) * sizeof(value_type));
+        }
+        if (blocks * block::size < t.size()) {
+            value_type previous = blocks > 0 ? t[blocks * block::size - 1] : 0;
+            auto       tail     = t.data() + blocks * block::size;
+            detail::write_leb128_array<value_type>(raw_writer, tail, t.size() - blocks * block::size, [&previous](value_type v) {
+                auto delta = v - previous;
+                previous   = v;
+                return delta;
+            });
+        }
+    }
+
+    template <class State>
+    std::size_t measure(State& state, const native_type& t) const {
+        if (t.size() > std::numeric_limits<native_length_type>::max())
+            throw serialization_exception();
+        auto       result = ast::measure<length_format>(state, static_cast<native_length_type>(t.size()));
+        const auto blocks = t.size() / block::size;
+        value_type deltas[block::size];
+        for (std::size_t b = 0; b < blocks; ++b)
+            result += reference_format::size.size() + 1 + block::words(block_deltas(t, b, deltas).width) * sizeof(value_type);
+        for (auto i = blocks * block::size; i < t.size(); ++i)
+            result += generic_format::detail::leb128_size(static_cast<value_type>(t[i] - (i > 0 ? t[i - 1] : 0)));
+        return result;
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        native_length_type length;
+        length_format().read(raw_reader, state, length);
+        const auto blocks = static_cast<std::size_t>(length) / block::size;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            skip_bytes(raw_reader, reference_format::size.size());
+            std::uint8_t width;
+            raw_reader(width);
+            if (width > block::max_width)
+                throw deserialization_exception();
+            skip_bytes(raw_reader, block::words(width) * sizeof(value_type));
+        }
+        for (auto i = blocks * block::size; i < static_cast<std::size_t>(length); ++i)
+            detail::read_leb128<value_type>(raw_reader);
+    }
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State& state, native_type& t) const {
+        native_length_type length;
+        length_format().read(raw_reader, state, length);
+        if (length > std::numeric_limits<std::size_t>::max())
+            throw deserialization_exception();
+        const auto blocks = static_cast<std::size_t>(length) / block::size;
+        const auto tail   = static_cast<std::size_t>(length) % block::size;
+        // check the capacity before allocating, such that a malformed length cannot trigger a huge allocation:
+        // each block takes at least the reference and the width, and each remaining value at least 1 byte
+        if constexpr (BoundedContiguousRawReader<RawReader>) {
+            const auto minimum = block_size(blocks, reference_format::size.size() + 1);
+            if (minimum > raw_reader.remaining() || tail > raw_reader.remaining() - minimum)
+                throw deserialization_exception();
+            t.resize(static_cast<std::size_t>(length));
+        } else {
+            // the available input is unknown, so the vector only grows with the blocks actually read
+            t.clear();
+        }
+        value_type previous[block::lanes]{};
+        value_type buffer[block::words(block::max_width)];
+        for (std::size_t b = 0; b < blocks; ++b) {
+            value_type   reference;
+            std::uint8_t width;
+            reference_format().read(raw_reader, state, reference);
+            raw_reader(width);
+            if (width > block::max_width)
+                throw deserialization_exception();
+            const auto bytes = block::words(width) * sizeof(value_type);
+            const unsigned char* words;
+            if constexpr (ContiguousRawReader<RawReader> && std::endian::native == std::endian::little) {
+                words = static_cast<const unsigned char*>(raw_reader.view(bytes));
+            } else {
+                raw_reader(static_cast<void*>(buffer), bytes);
+                convert_little_endian(buffer, block::words(width));
+                words = reinterpret_cast<const unsigned char*>(buffer);
+            }
+            if constexpr (!BoundedContiguousRawReader<RawReader>)
+                t.resize((b + 1) * block::size);
+            generic_format::detail::bitunpack_delta_128(words, width, reference, t.data() + b * block::size, previous);
+        }
+        if (tail > 0) {
+            if constexpr (!BoundedContiguousRawReader<RawReader>)
+                t.resize(static_cast<std::size_t>(length));
+            auto values = t.data() + blocks * block::size;
+            detail::read_leb128_array(raw_reader, values, tail);
+            value_type current = blocks > 0 ? t[blocks * block::size - 1] : 0;
+            for (std::size_t i = 0; i < tail; ++i)
+                values[i] = current += values[i];
+        }
+    }
+
+private:
+    using block            = generic_format::detail::bitpacked_block;
+    using reference_format = ordered_raw<value_type, std::endian::little>;
+
+    struct frame {
+        value_type reference;
+        unsigned   width;
+    };
+
+    /// Computes the deltas of block `b` relative to their frame of reference, and returns the frame.
+    static frame block_deltas(const native_type& t, std::size_t b, value_type (&deltas)[block::size]) {
+        const auto values = t.data() + b * block::size;
+        for (std::size_t i = 0; i < block::size; ++i)
+            deltas[i] = values[i] - (i >= block::lanes ? values[i - block::lanes] : previous_value(t, b * block::size + i));
+        const auto reference = *std::min_element(deltas, deltas + block::size);
+        value_type any_bits  = 0;
+        for (auto& delta : deltas) {
+            delta -= reference;
+            any_bits |= delta;
+        }
+        return {reference, static_cast<unsigned>(std::bit_width(any_bits))};
+    }
+
+    /// The value 4 positions before the value at `index`, within the previous block, or 0 in the first block.
+    static value_type previous_value(const native_type& t, std::size_t index) {
+        return index >= block::lanes ? t[index - block::lanes] : 0;
+    }
+
+    /// Converts between little endian and the byte order of the host.
+    static void convert_little_endian(value_type* words, std::size_t count) {
+        if constexpr (std::endian::native == std::endian::big)
+            generic_format::detail::byteswap_array<sizeof(value_type)>(words, words, count);
+    }
+};
+
+} // end namespace generic_format::ast
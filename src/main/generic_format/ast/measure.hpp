@@ -0,0 +1,41 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "generic_format/ast/base.hpp"
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/ast/variable.hpp"
+
+namespace generic_format::ast {
+
+/** @brief A format whose serialized size is known at compile time, and which does not need to be walked to be measured.
+ *
+ * Fixed-size formats containing variables still need to be walked, since they set the variables for the following formats.
+ */
+template <class F>
+concept StaticallySizedFormat = FixedSizeFormat<F> && !uses_variables<F>::value;
+
+/** @brief Returns the exact number of bytes which F writes for `t`, without writing anything.
+ *
+ * Statically sized formats return their size, all other formats are asked via their `measure(state, t, ...)` method,
+ * which mirrors their `write(raw_writer, state, t, ...)` method. Additional arguments (e.g. the index of an item)
+ * are forwarded.
+ */
+template <Format F, class State, class T, class... Args>
+std::size_t measure(State& state, const T& t, Args&&... args) {
+    if constexpr (StaticallySizedFormat<F>)
+        return F::size.size();
+    else
+        return F().measure(state, t, std::forward<Args>(args)...);
+}
+
+} // end namespace generic_format::ast
@@ -34,6 +34,19 @@ public:
         return std::get<placeholder_map_get_index<Map, Placeholder>::value>(_tuple);
     }
 
+    /// Tells whether the value of the placeholder is kept, i.e. whether the format reads it.
+    template <typename Placeholder>
+    static constexpr bool contains() {
+        return placeholder_map_has<Map, Placeholder>::value;
+    }
+
+    /// Keeps the value of the placeholder, or drops it if the format never reads it.
+    template <typename Placeholder, class T>
+    void set(const T& t) {
+        if constexpr (contains<Placeholder>())
+            get<Placeholder>() = t;
+    }
+
 private:
     tuple_type _tuple;
 };
@@ -76,6 +76,9 @@ struct placeholder_map_get_index;
  * @tparam Map a placeholder_map
  * @tparam Entry the placeholder_map_entry to put into the map.
  */
+template <class Map, typename Placeholder>
+struct placeholder_map_has;
+
 template <class Map, class Entry>
 struct placeholder_map_put;
 
@@ -119,6 +122,9 @@ template <typename Placeholder, class... Entries>
 struct placeholder_map_get_index<placeholder_map<Entries...>, Placeholder>
     : variadic::index_of<placeholder_matcher<Placeholder>::template type, Entries...> { };
 
+template <typename Placeholder, class... Entries>
+struct placeholder_map_has<placeholder_map<Entries...>, Placeholder> : detail::placeholder_map_contains<Placeholder, Entries...> { };
+
 template <class... Entries>
 struct placeholder_map_tuple_type<placeholder_map<Entries...>> {
     using type = std::tuple<typename Entries::type...>;
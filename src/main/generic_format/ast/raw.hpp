@@ -8,10 +8,17 @@
 */
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+
 #include "generic_format/ast/base.hpp"
+#include "generic_format/byteswap.hpp"
 
 namespace generic_format::ast {
 
+/// Copies the bytes of the native type, i.e. uses the byte order of the host.
 template <class T>
 struct raw : base<format_list<>> {
     using native_type          = T;
@@ -28,4 +35,55 @@ struct raw : base<format_list<>> {
     }
 };
 
+/// Copies the bytes of an integer in reverse order.
+template <class T>
+struct byte_swapped : base<format_list<>> {
+    static_assert(std::is_integral<T>::value, "Only integers can be byte-swapped!");
+    using native_type          = T;
+    static constexpr auto size = fixed_size(sizeof(T));
+
+    template <class RawWriter, class State>
+    void write(RawWriter& raw_writer, State&, const native_type& t) const {
+        raw_writer(generic_format::detail::byteswap(t));
+    }
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State&, T& t) const {
+        T value;
+        raw_reader(value);
+        t = generic_format::detail::byteswap(value);
+    }
+
+    /// Writes `count` contiguous values, swapping them in blocks.
+    template <class RawWriter>
+    static void write_array(RawWriter& raw_writer, const T* values, std::size_t count) {
+        static constexpr std::size_t block_size = 4096 / sizeof(T);
+        T                            block[block_size];
+        while (count > 0) {
+            auto n = std::min(count, block_size);
+            generic_format::detail::byteswap_array<sizeof(T)>(block, values, n);
+            raw_writer(static_cast<const void*>(block), n * sizeof(T));
+            values += n;
+            count -= n;
+        }
+    }
+
+    /// Reads `count` contiguous values, and swaps them in-place.
+    template <class RawReader>
+    static void read_array(RawReader& raw_reader, T* values, std::size_t count) {
+        raw_reader(static_cast<void*>(values), count * sizeof(T));
+        generic_format::detail::byteswap_array<sizeof(T)>(values, values, count);
+    }
+};
+
+/// Tells whether F byte-swaps values of T, such that arrays of them can be swapped in bulk.
+template <class F, class T>
+struct is_byte_swapped : std::is_base_of<byte_swapped<T>, std::remove_cv_t<F>> { };
+
+static_assert(std::endian::native == std::endian::little || std::endian::native == std::endian::big, "Mixed endianness is not supported!");
+
+/// Stores integers in the given byte order, independently of the byte order of the host.
+template <class T, std::endian Order>
+using ordered_raw = std::conditional_t<Order == std::endian::native || sizeof(T) == 1, raw<T>, byte_swapped<T>>;
+
 } // end namespace generic_format::ast
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "generic_format/ast/base.hpp"
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/ast/skip.hpp"
 #include "generic_format/accessor/accessor.hpp"
 
 #include <type_traits>
@@ -83,6 +85,36 @@ requires(FA::is_reference && !FA::is_indexed) struct dereference<reference<FA>>
         return result;
     }
 
+    template <class State>
+    std::size_t measure(State& state, const native_type& t, std::size_t = 0) const {
+        return ast::measure<format>(state, acc()(t));
+    }
+
+    /// The referenced value, e.g. the size of a repeated format.
+    template <class State>
+    const small_type& get(State&, const native_type& t) const {
+        return acc()(t);
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state, std::size_t = 0) const {
+        ast::skip<format>(raw_reader, state);
+    }
+
+    /// Reads the referenced value without storing it, e.g. to skip a repeated format.
+    template <class RawReader, class State>
+    small_type read_value(RawReader& raw_reader, State& state) const {
+        small_type value;
+        format().read(raw_reader, state, value);
+        return value;
+    }
+
+    /// Stores a value obtained by read_value(), e.g. after checking the size of a repeated format.
+    template <class State>
+    void set(State&, native_type& t, const small_type& value) const {
+        acc()(t) = value;
+    }
+
     template <class RawReader, class State>
     const auto& read(RawReader& raw_reader, State& state, native_type& t, std::size_t = 0) const {
         format().read(raw_reader, state, acc()(t));
@@ -104,6 +136,36 @@ requires(!FA::is_reference && !FA::is_indexed) struct dereference<reference<FA>>
         return result;
     }
 
+    template <class State>
+    std::size_t measure(State& state, const native_type& t, std::size_t = 0) const {
+        return ast::measure<format>(state, acc().get(t));
+    }
+
+    /// The referenced value, e.g. the size of a repeated format.
+    template <class State>
+    small_type get(State&, const native_type& t) const {
+        return acc().get(t);
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state, std::size_t = 0) const {
+        ast::skip<format>(raw_reader, state);
+    }
+
+    /// Reads the referenced value without storing it, e.g. to skip a repeated format.
+    template <class RawReader, class State>
+    small_type read_value(RawReader& raw_reader, State& state) const {
+        small_type value;
+        format().read(raw_reader, state, value);
+        return value;
+    }
+
+    /// Stores a value obtained by read_value(), e.g. after checking the size of a repeated format.
+    template <class State>
+    void set(State&, native_type& t, const small_type& value) const {
+        acc().set(t, value);
+    }
+
     template <class RawReader, class State>
     auto read(RawReader& raw_reader, State& state, native_type& t, std::size_t = 0) const {
         small_type value;
@@ -127,6 +189,16 @@ requires(FA::is_reference&& FA::is_indexed) struct dereference<reference<FA>> :
         return result;
     }
 
+    template <class State>
+    std::size_t measure(State& state, const native_type& t, std::size_t i) const {
+        return ast::measure<format>(state, acc()(t, i));
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state, std::size_t = 0) const {
+        ast::skip<format>(raw_reader, state);
+    }
+
     template <class RawReader, class State>
     auto read(RawReader& raw_reader, State& state, native_type& t, std::size_t i) const {
         small_type value;
@@ -8,11 +8,37 @@
 */
 #pragma once
 
+#include "generic_format/accessor/accessor.hpp"
 #include "generic_format/ast/base.hpp"
+#include "generic_format/ast/bytewise.hpp"
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/ast/skip.hpp"
+#include "generic_format/ast/reference.hpp"
+#include <iterator>
+#include <type_traits>
 #include <vector>
 
 namespace generic_format::ast {
 
+namespace detail {
+
+/// Tells whether a repeated value format accesses the items of a contiguous vector, which can then be copied as one block.
+template <class ValueFormat>
+struct contiguous_vector_items : std::false_type { };
+
+template <class Vector, class Element, class F>
+requires std::contiguous_iterator<typename Vector::iterator>
+struct contiguous_vector_items<dereference<reference<formatted_accessor<accessor::vector_item_accessor<Vector, Element>, F>>>>
+    : std::is_same<typename Vector::value_type, Element> {
+    using element_format = F;
+    using element_type   = Element;
+
+    static constexpr bool is_bulk_copyable = is_bytewise_array_element<F, Element>();
+};
+
+} // end namespace detail
+
 /** @brief
  *
  */
@@ -32,15 +58,90 @@ struct repeated : base<format_list<SizeReference, ValueFormat>> {
 
     template <class RawWriter, class State>
     void write(RawWriter& raw_writer, State& state, const native_type& t) const {
-        auto         length = size_reference().write(raw_writer, state, t);
+        auto length = size_reference().write(raw_writer, state, t);
+        if constexpr (FixedSizeFormat<value_format>) {
+            with_capacity(raw_writer, block_size(length, value_format::size.size()), [&](auto& w) { write_values(w, state, t, length); });
+        } else {
+            write_values(raw_writer, state, t, length);
+        }
+    }
+
+    template <class State>
+    std::size_t measure(State& state, const native_type& t) const {
+        auto result = ast::measure<size_reference>(state, t);
+        auto length = size_reference().get(state, t);
+        if constexpr (StaticallySizedFormat<value_format>) {
+            return result + block_size(length, value_format::size.size());
+        } else {
+            for (std::size_t i = 0; i < length; ++i)
+                result += ast::measure<value_format>(state, t, i);
+            return result;
+        }
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        auto length = size_reference().read_value(raw_reader, state);
+        if constexpr (StaticallySizedFormat<value_format>) {
+            skip_bytes(raw_reader, block_size(length, value_format::size.size()));
+        } else {
+            for (std::size_t i = 0; i < length; ++i)
+                ast::skip<value_format>(raw_reader, state);
+        }
+    }
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State& state, native_type& t) const {
+        // the size accessor might allocate (e.g. resize a vector), so the size is only applied once the capacity has been checked
+        auto length = size_reference().read_value(raw_reader, state);
+        if constexpr (FixedSizeFormat<value_format>) {
+            with_capacity(raw_reader, block_size(length, value_format::size.size()), [&](auto& r) {
+                size_reference().set(state, t, length);
+                read_values(r, state, t, length);
+            });
+        } else {
+            size_reference().set(state, t, length);
+            read_values(raw_reader, state, t, length);
+        }
+    }
+
+private:
+    template <class RawWriter, class State, typename Length>
+    void write_values(RawWriter& raw_writer, State& state, const native_type& t, Length length) const {
+        using items = detail::contiguous_vector_items<value_format>;
+        if constexpr (items::value) {
+            if (items::is_bulk_copyable && static_cast<std::size_t>(length) <= t.size()) {
+                raw_writer(static_cast<const void*>(t.data()), static_cast<std::size_t>(length) * sizeof(typename items::element_type));
+                return;
+            }
+            if constexpr (is_byte_swapped<typename items::element_format, typename items::element_type>::value) {
+                if (static_cast<std::size_t>(length) <= t.size()) {
+                    items::element_format::write_array(raw_writer, t.data(), static_cast<std::size_t>(length));
+                    return;
+                }
+            }
+        }
         value_format vf;
         for (std::size_t i = 0; i < length; ++i)
             vf.write(raw_writer, state, t, i);
     }
 
-    template <class RawReader, class State>
-    void read(RawReader& raw_reader, State& state, native_type& t) const {
-        auto         length = size_reference().read(raw_reader, state, t);
+    template <class RawReader, class State, typename Length>
+    void read_values(RawReader& raw_reader, State& state, native_type& t, Length length) const {
+        using items = detail::contiguous_vector_items<value_format>;
+        if constexpr (items::value) {
+            // the size accessor has already resized the vector
+            if (items::is_bulk_copyable && static_cast<std::size_t>(length) <= t.size()) {
+                raw_reader(static_cast<void*>(t.data()), static_cast<std::size_t>(length) * sizeof(typename items::element_type));
+                return;
+            }
+            if constexpr (is_byte_swapped<typename items::element_format, typename items::element_type>::value) {
+                if (static_cast<std::size_t>(length) <= t.size()) {
+                    items::element_format::read_array(raw_reader, t.data(), static_cast<std::size_t>(length));
+                    return;
+                }
+            }
+        }
         value_format vf;
         for (std::size_t i = 0; i < length; ++i)
             vf.read(raw_reader, state, t, i);
@@ -9,6 +9,10 @@
 #pragma once
 
 #include "generic_format/ast/base.hpp"
+#include "generic_format/ast/bytewise.hpp"
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/ast/skip.hpp"
 
 #include <tuple>
 
@@ -22,17 +26,36 @@ struct sequence<NativeType, format_list<Formats...>> : base<format_list<Formats.
 
     using native_type = NativeType;
 
-    static constexpr auto size               = sum(fixed_size(0), Formats::size...);
+    static constexpr auto size               = generic_format::sum(fixed_size(0), Formats::size...);
     static constexpr auto number_of_elements = sizeof...(Formats);
 
     template <class RawWriter, class State>
     void write(RawWriter& raw_writer, State& state, const native_type& t) const {
-        write_elements<RawWriter, State, Formats...>(raw_writer, state, t);
+        // e.g. adapted structs whose members are laid out exactly like the serialized data
+        if constexpr (bytewise<sequence, native_type>::value) {
+            raw_writer(static_cast<const void*>(&t), size.size());
+        } else {
+            write_elements<RawWriter, State, Formats...>(raw_writer, state, t);
+        }
+    }
+
+    template <class State>
+    std::size_t measure(State& state, const native_type& t) const {
+        return (ast::measure<Formats>(state, t) + ... + 0);
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        (ast::skip<Formats>(raw_reader, state), ...);
     }
 
     template <class RawReader, class State>
     void read(RawReader& raw_reader, State& state, native_type& t) const {
-        read_elements<RawReader, State, Formats...>(raw_reader, state, t);
+        if constexpr (bytewise<sequence, native_type>::value) {
+            raw_reader(static_cast<void*>(&t), size.size());
+        } else {
+            read_elements<RawReader, State, Formats...>(raw_reader, state, t);
+        }
     }
 
 private:
@@ -41,7 +64,7 @@ private:
 
     template <class RawWriter, class State, class F, class... FS>
     void write_elements(RawWriter& raw_writer, State& state, const native_type& t) const {
-        F().write(raw_writer, state, t);
+        write_checked<F>(raw_writer, state, t);
         write_elements<RawWriter, State, FS...>(raw_writer, state, t);
     }
 
@@ -50,7 +73,7 @@ private:
 
     template <class RawReader, class State, class F, class... FS>
     void read_elements(RawReader& raw_reader, State& state, native_type& t) const {
-        F().read(raw_reader, state, t);
+        read_checked<F>(raw_reader, state, t);
         read_elements<RawReader, State, FS...>(raw_reader, state, t);
     }
 };
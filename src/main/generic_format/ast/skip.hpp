@@ -0,0 +1,31 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include "generic_format/ast/base.hpp"
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/ast/measure.hpp"
+
+namespace generic_format::ast {
+
+/** @brief Advances a raw reader past a value of F, without decoding it.
+ *
+ * Statically sized formats are skipped as a whole (see skip_bytes()), all other formats are asked via their
+ * `skip(raw_reader, state)` method, which only reads what is needed to find the end of the value (e.g. lengths),
+ * and the variables.
+ */
+template <Format F, class RawReader, class State>
+void skip(RawReader& raw_reader, State& state) {
+    if constexpr (StaticallySizedFormat<F>)
+        skip_bytes(raw_reader, F::size.size());
+    else
+        F().skip(raw_reader, state);
+}
+
+} // end namespace generic_format::ast
@@ -0,0 +1,123 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "generic_format/ast/base.hpp"
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/exceptions.hpp"
+#include "generic_format/stream_vbyte.hpp"
+
+namespace generic_format::ast {
+
+/** @brief Encodes a vector of 32-bit integers in the Stream VByte layout.
+ *
+ * The length is followed by the control bytes, which store the number of bytes (1 to 4) of 4 values each,
+ * and by the little-endian bytes of all values (see generic_format::detail::stream_vbyte).
+ * The encoding is about as compact as LEB128, but the position of each value is known from the control bytes alone,
+ * which makes decoding much faster for values of mixed lengths.
+ */
+template <IntegralFormat LengthFormat>
+struct stream_vbyte : base<format_list<LengthFormat>> {
+    using length_format        = LengthFormat;
+    using native_length_type   = typename length_format::native_type;
+    using value_type           = std::uint32_t;
+    using native_type          = std::vector<value_type>;
+    static constexpr auto size = dynamic_size();
+
+    template <class RawWriter, class State>
+    void write(RawWriter& raw_writer, State& state, const native_type& t) const {
+        if (t.size() > std::numeric_limits<native_length_type>::max())
+            throw serialization_exception();
+        length_format().write(raw_writer, state, static_cast<native_length_type>(t.size()));
+        const auto                 control_size = codec::control_size(t.size());
+        std::vector<unsigned char> buffer(control_size + t.size() * sizeof(value_type));
+        const auto data_size = generic_format::detail::stream_vbyte_encode(t.data(), t.size(), buffer.data(), buffer.data() + control_size);
+        raw_writer(static_cast<const void*>(buffer.data()), control_size + data_size);
+    }
+
+    template <class State>
+    std::size_t measure(State& state, const native_type& t) const {
+        if (t.size() > std::numeric_limits<native_length_type>::max())
+            throw serialization_exception();
+        auto result = ast::measure<length_format>(state, static_cast<native_length_type>(t.size())) + codec::control_size(t.size());
+        for (auto v : t)
+            result += codec::code(v) + 1;
+        return result;
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        const auto                 length = read_length(raw_reader, state);
+        std::vector<unsigned char> buffer;
+        skip_bytes(raw_reader, generic_format::detail::stream_vbyte_data_size(read_control(raw_reader, length, buffer), length));
+    }
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State& state, native_type& t) const {
+        const auto length = read_length(raw_reader, state);
+        // check the capacity before allocating, such that a malformed length cannot trigger a huge allocation:
+        // each value takes at least 1 byte, plus its share of the control bytes
+        if constexpr (BoundedContiguousRawReader<RawReader>) {
+            if (length > raw_reader.remaining() || codec::control_size(length) > raw_reader.remaining() - length)
+                throw deserialization_exception();
+        }
+        std::vector<unsigned char> control_buffer;
+        const auto                 control   = read_control(raw_reader, length, control_buffer);
+        const auto                 data_size = generic_format::detail::stream_vbyte_data_size(control, length);
+        std::vector<unsigned char> data_buffer;
+        const unsigned char*       data;
+        if constexpr (ContiguousRawReader<RawReader>) {
+            data = static_cast<const unsigned char*>(raw_reader.view(data_size));
+        } else {
+            with_capacity(raw_reader, data_size, [&](auto& r) {
+                data_buffer.resize(data_size);
+                r(static_cast<void*>(data_buffer.data()), data_size);
+            });
+            data = data_buffer.data();
+        }
+        // the control bytes have been read, so the length is bounded by the input
+        t.resize(length);
+        generic_format::detail::stream_vbyte_decode(control, data, data + data_size, t.data(), length);
+    }
+
+private:
+    using codec = generic_format::detail::stream_vbyte;
+
+    template <class RawReader, class State>
+    static std::size_t read_length(RawReader& raw_reader, State& state) {
+        native_length_type length;
+        length_format().read(raw_reader, state, length);
+        if (length > std::numeric_limits<std::size_t>::max())
+            throw deserialization_exception();
+        return static_cast<std::size_t>(length);
+    }
+
+    /// Returns the control bytes of `length` values, which are copied into `buffer` unless the reader exposes its storage.
+    template <class RawReader>
+    static const unsigned char* read_control(RawReader& raw_reader, std::size_t length, std::vector<unsigned char>& buffer) {
+        const auto control_size = codec::control_size(length);
+        if constexpr (ContiguousRawReader<RawReader>) {
+            return static_cast<const unsigned char*>(raw_reader.view(control_size));
+        } else {
+            with_capacity(raw_reader, control_size, [&](auto& r) {
+                buffer.resize(control_size);
+                r(static_cast<void*>(buffer.data()), control_size);
+            });
+            return buffer.data();
+        }
+    }
+};
+
+} // end namespace generic_format::ast
@@ -9,36 +9,103 @@
 #pragma once
 
 #include "generic_format/ast/base.hpp"
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/ast/skip.hpp"
+
+#include <string>
+#include <string_view>
 
 namespace generic_format::ast {
 
-/** @brief A format representing a string which is serialized via its length followed by its data.
- *
- * @tparam LengthFormat the format used to serialize the length.
- */
+namespace detail {
+
 template <IntegralFormat LengthFormat>
-struct string : base<format_list<LengthFormat>> {
-    using native_type          = std::string;
+struct string_base : base<format_list<LengthFormat>> {
     using length_format        = LengthFormat;
     using native_length_type   = typename length_format::native_type;
     static constexpr auto size = dynamic_size();
 
     template <class RawWriter, class State>
-    void write(RawWriter& raw_writer, State& state, const std::string& s) const {
+    void write(RawWriter& raw_writer, State& state, std::string_view s) const {
         if (s.length() > std::numeric_limits<native_length_type>::max())
             throw serialization_exception();
         length_format().write(raw_writer, state, static_cast<native_length_type>(s.length()));
         raw_writer(reinterpret_cast<const void*>(s.data()), s.length());
     }
 
+    template <class State>
+    std::size_t measure(State& state, std::string_view s) const {
+        if (s.length() > std::numeric_limits<native_length_type>::max())
+            throw serialization_exception();
+        return ast::measure<length_format>(state, static_cast<native_length_type>(s.length())) + s.length();
+    }
+
     template <class RawReader, class State>
-    void read(RawReader& raw_reader, State& state, std::string& s) const {
+    void skip(RawReader& raw_reader, State& state) const {
+        skip_bytes(raw_reader, read_length(raw_reader, state));
+    }
+
+protected:
+    template <class RawReader, class State>
+    std::size_t read_length(RawReader& raw_reader, State& state) const {
         native_length_type length;
         length_format().read(raw_reader, state, length);
         if (length > std::numeric_limits<std::size_t>::max())
             throw deserialization_exception();
-        s = std::string(static_cast<std::size_t>(length), 0); // TODO(sw) we don't need to fill the string
-        raw_reader(const_cast<void*>(reinterpret_cast<const void*>(s.data())), s.length());
+        return static_cast<std::size_t>(length);
+    }
+};
+
+} // end namespace detail
+
+/** @brief A format representing a string which is serialized via its length followed by its data.
+ *
+ * @tparam LengthFormat the format used to serialize the length.
+ */
+template <IntegralFormat LengthFormat>
+struct string : detail::string_base<LengthFormat> {
+    using native_type = std::string;
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State& state, std::string& s) const {
+        auto length = this->read_length(raw_reader, state);
+        if constexpr (ContiguousRawReader<RawReader>) {
+            s.assign(static_cast<const char*>(raw_reader.view(length)), length);
+        } else {
+            // check the capacity before allocating, such that a malformed length cannot trigger a huge allocation
+            with_capacity(raw_reader, length, [&](auto& r) {
+                s = std::string(length, 0); // TODO(sw) we don't need to fill the string
+                r(const_cast<void*>(reinterpret_cast<const void*>(s.data())), s.length());
+            });
+        }
+    }
+};
+
+/** @brief A format like string, which deserializes into a std::string_view instead of allocating a std::string.
+ *
+ * On raw readers exposing contiguous storage, the view points directly into the storage, and stays valid as long as the storage.
+ * Otherwise the data is copied into the arena of the raw reader, and the view stays valid as long as the raw reader.
+ *
+ * @tparam LengthFormat the format used to serialize the length.
+ */
+template <IntegralFormat LengthFormat>
+struct string_view : detail::string_base<LengthFormat> {
+    using native_type = std::string_view;
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State& state, std::string_view& s) const {
+        auto length = this->read_length(raw_reader, state);
+        if constexpr (ContiguousRawReader<RawReader>) {
+            s = std::string_view(static_cast<const char*>(raw_reader.view(length)), length);
+        } else {
+            static_assert(requires { raw_reader.arena(); }, "The raw reader neither exposes contiguous storage nor an arena!");
+            with_capacity(raw_reader, length, [&](auto& r) {
+                auto data = raw_reader.arena().allocate(length);
+                r(static_cast<void*>(data), length);
+                s = std::string_view(data, length);
+            });
+        }
     }
 };
 
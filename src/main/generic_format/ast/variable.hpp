@@ -9,9 +9,11 @@
 #pragma once
 
 #include <functional>
+#include <type_traits>
 
 #include "generic_format/accessor/accessor.hpp"
 #include "generic_format/ast/base.hpp"
+#include "generic_format/ast/capacity.hpp"
 
 namespace generic_format::ast {
 
@@ -23,6 +25,9 @@ concept Variable = std::is_base_of<variable_base, T>::value;
 template <typename Placeholder, Format ElementType>
 requires(!Variable<ElementType>) struct variable;
 
+template <Format F>
+struct uses_variables;
+
 namespace detail {
 template <Variable Variable1, Variable Variable2, class Operator>
 struct binary_operator;
@@ -87,13 +92,35 @@ requires(!Variable<ElementType>) struct variable : base<format_list<ElementType>
     void write(RawWriter& raw_writer, State& state, const native_type& t) const {
         element_type().write(raw_writer, state, t);
 
-        state.template get<placeholder>() = t;
+        state.template set<placeholder>(t);
+    }
+
+    template <class State>
+    std::size_t measure(State& state, const native_type& t) const {
+        std::size_t result;
+        if constexpr (element_type::size.is_fixed())
+            result = element_type::size.size();
+        else
+            result = element_type().measure(state, t);
+        state.template set<placeholder>(t);
+        return result;
+    }
+
+    /// Variables are read even when skipped, if following formats depend on them.
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        if constexpr (!State::template contains<placeholder>() && element_type::size.is_fixed() && !uses_variables<element_type>::value)
+            skip_bytes(raw_reader, element_type::size.size());
+        else {
+            native_type t;
+            read(raw_reader, state, t);
+        }
     }
 
     template <class RawReader, class State>
     void read(RawReader& raw_reader, State& state, native_type& t) const {
         element_type().read(raw_reader, state, t);
-        state.template get<placeholder>() = t;
+        state.template set<placeholder>(t);
     }
 
     template <class State>
@@ -125,6 +152,18 @@ struct evaluator<variable<Placeholder, ElementType>> : base<format_list<>> {
     }
 };
 
+namespace detail {
+template <class Children>
+struct any_uses_variables;
+
+template <Format... Formats>
+struct any_uses_variables<format_list<Formats...>> : std::bool_constant<(uses_variables<Formats>::value || ...)> { };
+} // end namespace detail
+
+/// Tells whether F or any of its children is a variable, i.e. whether writing or reading F may need a placeholder_container.
+template <Format F>
+struct uses_variables : std::bool_constant<Variable<F> || detail::any_uses_variables<typename F::children>::value> { };
+
 template <class VariableEvaluator, accessor::Accessor A, class Enable = void>
 struct variable_accessor_binding;
 
@@ -146,6 +185,29 @@ requires(!Accessor::is_reference && !Accessor::is_indexed) struct variable_acces
         return variable_evaluator()(state);
     }
 
+    template <class State, class NativeType>
+    std::size_t measure(State&, const NativeType&) const {
+        return 0;
+    }
+
+    template <class State, class NativeType>
+    auto get(State& state, const NativeType&) const {
+        return variable_evaluator()(state);
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader&, State&) const { }
+
+    template <class RawReader, class State>
+    small_type read_value(RawReader&, State& state) const {
+        return variable_evaluator()(state);
+    }
+
+    template <class State>
+    void set(State&, big_type& t, const small_type& value) const {
+        accessor().set(t, value);
+    }
+
     template <class RawReader, class State>
     auto read(RawReader&, State& state, big_type& t) const {
         small_type result = variable_evaluator()(state);
@@ -154,4 +216,51 @@ requires(!Accessor::is_reference && !Accessor::is_indexed) struct variable_acces
     }
 };
 
+/** @brief Tells whether F or any of its children reads the value of the placeholder, i.e. evaluates its variable.
+ *
+ * Placeholders which are written but never read don't need to be kept in the placeholder_container.
+ */
+template <Format F, typename Placeholder>
+struct reads_placeholder;
+
+namespace detail {
+/// Tells whether an expression of variables, e.g. an evaluator of a product of variables, reads the placeholder.
+template <class Expression, typename Placeholder>
+struct expression_reads_placeholder : std::false_type { };
+
+template <typename VariablePlaceholder, Format ElementType, typename Placeholder>
+struct expression_reads_placeholder<variable<VariablePlaceholder, ElementType>, Placeholder> : std::is_same<VariablePlaceholder, Placeholder> { };
+
+template <Variable V, typename Placeholder>
+struct expression_reads_placeholder<evaluator<V>, Placeholder> : expression_reads_placeholder<V, Placeholder> { };
+
+template <Variable V, typename Placeholder>
+requires requires {
+    typename V::left_type;
+    typename V::right_type;
+}
+struct expression_reads_placeholder<V, Placeholder>
+    : std::bool_constant<expression_reads_placeholder<typename V::left_type, Placeholder>::value
+                         || expression_reads_placeholder<typename V::right_type, Placeholder>::value> { };
+
+/// Variables are read by variable_accessor_bindings.
+template <Format F, typename Placeholder>
+struct binding_reads_placeholder : std::false_type { };
+
+template <Format F, typename Placeholder>
+requires requires { typename F::variable_evaluator; }
+struct binding_reads_placeholder<F, Placeholder> : expression_reads_placeholder<typename F::variable_evaluator, Placeholder> { };
+
+template <class Children, typename Placeholder>
+struct any_reads_placeholder;
+
+template <Format... Formats, typename Placeholder>
+struct any_reads_placeholder<format_list<Formats...>, Placeholder> : std::bool_constant<(reads_placeholder<Formats, Placeholder>::value || ...)> { };
+} // end namespace detail
+
+template <Format F, typename Placeholder>
+struct reads_placeholder
+    : std::bool_constant<detail::binding_reads_placeholder<F, Placeholder>::value
+                         || detail::any_reads_placeholder<typename F::children, Placeholder>::value> { };
+
 } // end namespace generic_format::ast
@@ -0,0 +1,194 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+#include "generic_format/ast/base.hpp"
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/exceptions.hpp"
+#include "generic_format/leb128.hpp"
+
+namespace generic_format::ast {
+
+/** @brief Tests whether a raw reader exposes contiguous storage of known length.
+ *
+ * In addition to `view(size)`, such a raw reader provides `remaining()`, such that formats of unknown size
+ * can be decoded directly from the storage at `view(0)`.
+ */
+template <class Raw>
+concept BoundedContiguousRawReader = ContiguousRawReader<Raw> && requires(const Raw& raw) {
+    { raw.remaining() } -> std::convertible_to<std::size_t>;
+};
+
+namespace detail {
+
+template <class T, class RawWriter>
+void write_leb128(RawWriter& raw_writer, T value) {
+    unsigned char buffer[generic_format::detail::leb128_max_size<T>];
+    raw_writer(static_cast<const void*>(buffer), generic_format::detail::leb128_encode(value, buffer));
+}
+
+template <class T, class RawReader>
+T read_leb128(RawReader& raw_reader) {
+    T value;
+    if constexpr (BoundedContiguousRawReader<RawReader>) {
+        auto begin = static_cast<const unsigned char*>(raw_reader.view(0));
+        auto end   = generic_format::detail::leb128_decode(begin, begin + raw_reader.remaining(), value);
+        if (!end)
+            throw deserialization_exception();
+        raw_reader.view(static_cast<std::size_t>(end - begin));
+    } else {
+        unsigned char buffer[generic_format::detail::leb128_max_size<T>];
+        std::size_t   length = 0;
+        do {
+            if (length == sizeof(buffer))
+                throw deserialization_exception();
+            raw_reader(buffer[length++]);
+        } while (buffer[length - 1] & 0x80);
+        if (!generic_format::detail::leb128_decode_known_length(buffer, length, value))
+            throw deserialization_exception();
+    }
+    return value;
+}
+
+/// Encodes contiguous values through a buffer, mapping each value with `encode` first.
+template <class T, class RawWriter, class Value, class Encode>
+void write_leb128_array(RawWriter& raw_writer, const Value* values, std::size_t count, Encode encode) {
+    constexpr std::size_t buffer_size = 4096;
+    unsigned char         buffer[buffer_size];
+    std::size_t           used = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (buffer_size - used < generic_format::detail::leb128_max_size<T>) {
+            raw_writer(static_cast<const void*>(buffer), used);
+            used = 0;
+        }
+        used += generic_format::detail::leb128_encode(encode(values[i]), buffer + used);
+    }
+    if (used > 0)
+        raw_writer(static_cast<const void*>(buffer), used);
+}
+
+/// Decodes contiguous values, in batches if the raw reader exposes its storage.
+template <class T, class RawReader>
+void read_leb128_array(RawReader& raw_reader, T* values, std::size_t count) {
+    if constexpr (BoundedContiguousRawReader<RawReader>) {
+        auto begin = static_cast<const unsigned char*>(raw_reader.view(0));
+        auto end   = generic_format::detail::leb128_decode_batch(begin, begin + raw_reader.remaining(), values, count);
+        if (!end)
+            throw deserialization_exception();
+        raw_reader.view(static_cast<std::size_t>(end - begin));
+    } else {
+        for (std::size_t i = 0; i < count; ++i)
+            values[i] = read_leb128<T>(raw_reader);
+    }
+}
+
+} // end namespace detail
+
+/** @brief Encodes an unsigned integer as LEB128, i.e. in groups of 7 bits, least significant group first.
+ *
+ * Values below 128 take a single byte.
+ */
+template <class T>
+struct varint : base<format_list<>> {
+    static_assert(std::is_unsigned<T>::value, "varint encodes unsigned integers, use zigzag for signed integers!");
+    using native_type          = T;
+    static constexpr auto size = dynamic_size();
+
+    template <class RawWriter, class State>
+    void write(RawWriter& raw_writer, State&, const native_type& t) const {
+        detail::write_leb128(raw_writer, t);
+    }
+
+    template <class State>
+    std::size_t measure(State&, const native_type& t) const {
+        return generic_format::detail::leb128_size(t);
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State&) const {
+        detail::read_leb128<T>(raw_reader);
+    }
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State&, native_type& t) const {
+        t = detail::read_leb128<T>(raw_reader);
+    }
+
+    /// Writes `count` contiguous values.
+    template <class RawWriter>
+    static void write_array(RawWriter& raw_writer, const T* values, std::size_t count) {
+        detail::write_leb128_array<T>(raw_writer, values, count, [](T v) { return v; });
+    }
+
+    /// Reads `count` contiguous values.
+    template <class RawReader>
+    static void read_array(RawReader& raw_reader, T* values, std::size_t count) {
+        detail::read_leb128_array(raw_reader, values, count);
+    }
+};
+
+/** @brief Encodes a signed integer as the LEB128 encoding of its zigzag mapping (0, -1, 1, -2, ... map to 0, 1, 2, 3, ...).
+ *
+ * Values between -64 and 63 take a single byte.
+ */
+template <class T>
+struct zigzag : base<format_list<>> {
+    static_assert(std::is_signed<T>::value && std::is_integral<T>::value, "zigzag encodes signed integers!");
+    using native_type          = T;
+    using unsigned_type        = std::make_unsigned_t<T>;
+    static constexpr auto size = dynamic_size();
+
+    template <class RawWriter, class State>
+    void write(RawWriter& raw_writer, State&, const native_type& t) const {
+        detail::write_leb128(raw_writer, generic_format::detail::zigzag_encode(t));
+    }
+
+    template <class State>
+    std::size_t measure(State&, const native_type& t) const {
+        return generic_format::detail::leb128_size(generic_format::detail::zigzag_encode(t));
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State&) const {
+        detail::read_leb128<unsigned_type>(raw_reader);
+    }
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State&, native_type& t) const {
+        t = generic_format::detail::zigzag_decode<T>(detail::read_leb128<unsigned_type>(raw_reader));
+    }
+
+    /// Writes `count` contiguous values.
+    template <class RawWriter>
+    static void write_array(RawWriter& raw_writer, const T* values, std::size_t count) {
+        detail::write_leb128_array<unsigned_type>(raw_writer, values, count, [](T v) { return generic_format::detail::zigzag_encode(v); });
+    }
+
+    /// Reads `count` contiguous values.
+    template <class RawReader>
+    static void read_array(RawReader& raw_reader, T* values, std::size_t count) {
+        // signed and unsigned variants of a type may alias each other
+        auto encoded = reinterpret_cast<unsigned_type*>(values);
+        detail::read_leb128_array(raw_reader, encoded, count);
+        for (std::size_t i = 0; i < count; ++i)
+            values[i] = generic_format::detail::zigzag_decode<T>(encoded[i]);
+    }
+};
+
+/// Tells whether F encodes values of T as LEB128, such that arrays of them can be encoded and decoded in batches.
+template <class F, class T>
+struct is_leb128 : std::integral_constant<bool,
+                                          std::is_base_of<varint<T>, std::remove_cv_t<F>>::value
+                                              || std::is_base_of<zigzag<T>, std::remove_cv_t<F>>::value> { };
+
+} // end namespace generic_format::ast
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "generic_format/ast/base.hpp"
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/ast/skip.hpp"
 #include <stdexcept>
 
 namespace generic_format {
@@ -61,6 +63,21 @@ struct versioned : base<format_list<VersionFormat, BaseFormat>> {
         base_format().write(raw_writer, state, value);
     }
 
+    template <class State>
+    std::size_t measure(State& state, const native_type& value) const {
+        return ast::measure<version_format>(state, CurrentVersion) + ast::measure<base_format>(state, value);
+    }
+
+    /// Checks the version, since the layout of other versions is unknown.
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        native_version_type version;
+        version_format().read(raw_reader, state, version);
+        if (version != CurrentVersion)
+            throw invalid_version<native_version_type>(CurrentVersion, version);
+        ast::skip<base_format>(raw_reader, state);
+    }
+
     template <class RawReader, class State>
     void read(RawReader& raw_reader, State& state, native_type& value) const {
         native_version_type version;
@@ -0,0 +1,142 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace generic_format::detail {
+
+/** @brief Blocks of 128 32-bit integers, packed with a common bit width.
+ *
+ * The values are interleaved over 4 lanes (value i goes to lane i % 4), and each lane is packed into 32-bit words,
+ * such that a block of bit width b takes 4 * b words, and can be unpacked with 128-bit SIMD instructions.
+ * Unpacking is fused with the decoding of frame-of-reference and stride-4 deltas (value i - value i-4).
+ */
+struct bitpacked_block {
+    static constexpr std::size_t size      = 128;
+    static constexpr std::size_t lanes     = 4;
+    static constexpr std::size_t per_lane  = size / lanes;
+    static constexpr unsigned    max_width = 32;
+
+    /// Number of 32-bit words of a block of the given bit width.
+    static constexpr std::size_t words(unsigned width) {
+        return lanes * width;
+    }
+};
+
+/// Packs 128 values, which must fit into `width` bits, into bitpacked_block::words(width) words.
+inline void bitpack_128(const std::uint32_t* in, unsigned width, std::uint32_t* out) {
+    std::fill(out, out + bitpacked_block::words(width), 0);
+    if (width == 0)
+        return;
+    for (std::size_t lane = 0; lane < bitpacked_block::lanes; ++lane) {
+        for (std::size_t k = 0; k < bitpacked_block::per_lane; ++k) {
+            auto value = in[bitpacked_block::lanes * k + lane];
+            auto bit   = k * width;
+            auto word  = bit / 32;
+            auto shift = bit % 32;
+            out[bitpacked_block::lanes * word + lane] |= value << shift;
+            if (shift + width > 32)
+                out[bitpacked_block::lanes * (word + 1) + lane] |= value >> (32 - shift);
+        }
+    }
+}
+
+inline std::uint32_t load_word(const unsigned char* in, std::size_t index) {
+    std::uint32_t word;
+    std::memcpy(&word, in + index * sizeof(word), sizeof(word));
+    return word;
+}
+
+/** @brief Unpacks a block, adds `reference` to each value, and sums up the stride-4 deltas starting from `previous` (which is updated).
+ *
+ * The packed words at `in` need not be aligned.
+ */
+template <unsigned Width>
+void bitunpack_delta_128_scalar(const unsigned char* in, std::uint32_t reference, std::uint32_t* out, std::uint32_t* previous) {
+    constexpr std::uint32_t mask = Width == 32 ? ~std::uint32_t{0} : (std::uint32_t{1} << Width) - 1;
+    for (std::size_t k = 0; k < bitpacked_block::per_lane; ++k) {
+        for (std::size_t lane = 0; lane < bitpacked_block::lanes; ++lane) {
+            std::uint32_t value = 0;
+            if constexpr (Width > 0) {
+                auto bit   = k * Width;
+                auto word  = bit / 32;
+                auto shift = bit % 32;
+                value      = load_word(in, bitpacked_block::lanes * word + lane) >> shift;
+                if (shift + Width > 32)
+                    value |= load_word(in, bitpacked_block::lanes * (word + 1) + lane) << (32 - shift);
+                value &= mask;
+            }
+            previous[lane] += value + reference;
+            out[bitpacked_block::lanes * k + lane] = previous[lane];
+        }
+    }
+}
+
+#if defined(__SSE2__)
+
+/// SSE2 version of bitunpack_delta_128_scalar, with all shifts known at compile-time.
+template <unsigned Width>
+void bitunpack_delta_128_sse2(const unsigned char* in, std::uint32_t reference, std::uint32_t* out, std::uint32_t* previous) {
+    const auto words   = reinterpret_cast<const __m128i*>(in);
+    const auto mask    = _mm_set1_epi32(static_cast<int>(Width == 32 ? ~std::uint32_t{0} : (std::uint32_t{1} << Width) - 1));
+    const auto ref     = _mm_set1_epi32(static_cast<int>(reference));
+    auto       current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous));
+    auto       step    = [&]<std::size_t K>(std::integral_constant<std::size_t, K>) {
+        __m128i value = _mm_setzero_si128();
+        if constexpr (Width > 0) {
+            constexpr unsigned bit   = K * Width;
+            constexpr unsigned word  = bit / 32;
+            constexpr unsigned shift = bit % 32;
+            value                    = _mm_srli_epi32(_mm_loadu_si128(words + word), shift);
+            if constexpr (shift + Width > 32)
+                value = _mm_or_si128(value, _mm_slli_epi32(_mm_loadu_si128(words + word + 1), 32 - shift));
+            if constexpr (Width < 32)
+                value = _mm_and_si128(value, mask);
+        }
+        current = _mm_add_epi32(current, _mm_add_epi32(value, ref));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + bitpacked_block::lanes * K), current);
+    };
+    [&]<std::size_t... K>(std::index_sequence<K...>) {
+        (step(std::integral_constant<std::size_t, K>{}), ...);
+    }(std::make_index_sequence<bitpacked_block::per_lane>{});
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(previous), current);
+}
+
+#endif
+
+using bitunpack_delta_function = void (*)(const unsigned char*, std::uint32_t, std::uint32_t*, std::uint32_t*);
+
+template <std::size_t... Widths>
+constexpr std::array<bitunpack_delta_function, sizeof...(Widths)> make_bitunpack_delta_table(std::index_sequence<Widths...>) {
+#if defined(__SSE2__)
+    return {&bitunpack_delta_128_sse2<Widths>...};
+#else
+    return {&bitunpack_delta_128_scalar<Widths>...};
+#endif
+}
+
+/// Unpacks a block of the given bit width (at most 32), see bitunpack_delta_128_scalar.
+inline void bitunpack_delta_128(const unsigned char* in, unsigned width, std::uint32_t reference, std::uint32_t* out, std::uint32_t* previous) {
+    static constexpr auto table = make_bitunpack_delta_table(std::make_index_sequence<bitpacked_block::max_width + 1>{});
+    table[width](in, reference, out, previous);
+}
+
+} // end namespace generic_format::detail
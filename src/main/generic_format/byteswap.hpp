@@ -0,0 +1,155 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "generic_format/simd.hpp"
+
+namespace generic_format::detail {
+
+template <std::size_t Size>
+struct unsigned_of_size;
+
+template <>
+struct unsigned_of_size<1> {
+    using type = std::uint8_t;
+};
+
+template <>
+struct unsigned_of_size<2> {
+    using type = std::uint16_t;
+};
+
+template <>
+struct unsigned_of_size<4> {
+    using type = std::uint32_t;
+};
+
+template <>
+struct unsigned_of_size<8> {
+    using type = std::uint64_t;
+};
+
+/// Reverses the bytes of an integer.
+template <class T>
+constexpr T byteswap(T value) noexcept {
+    static_assert(std::is_integral<T>::value, "Only integers can be byte-swapped!");
+    using U = typename unsigned_of_size<sizeof(T)>::type;
+    auto u  = static_cast<U>(value);
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (sizeof(T) == 2)
+        u = __builtin_bswap16(u);
+    else if constexpr (sizeof(T) == 4)
+        u = __builtin_bswap32(u);
+    else if constexpr (sizeof(T) == 8)
+        u = __builtin_bswap64(u);
+#else
+    U result = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        result = static_cast<U>((result << 8) | (u & 0xff));
+        u      = static_cast<U>(u >> 8);
+    }
+    u = result;
+#endif
+    return static_cast<T>(u);
+}
+
+template <std::size_t Size>
+void byteswap_array_scalar(unsigned char* dst, const unsigned char* src, std::size_t count) {
+    using U = typename unsigned_of_size<Size>::type;
+    for (std::size_t i = 0; i < count; ++i) {
+        U v;
+        std::memcpy(&v, src + i * Size, Size);
+        v = byteswap(v);
+        std::memcpy(dst + i * Size, &v, Size);
+    }
+}
+
+#ifdef GENERIC_FORMAT_X86_SIMD
+
+/// pshufb mask reversing each Size-byte element of a 16-byte lane.
+template <std::size_t Size>
+constexpr std::array<char, 16> byteswap_shuffle_mask() {
+    std::array<char, 16> mask{};
+    for (std::size_t i = 0; i < 16; ++i)
+        mask[i] = static_cast<char>(i / Size * Size + (Size - 1 - i % Size));
+    return mask;
+}
+
+template <std::size_t Size>
+__attribute__((target("ssse3"))) void byteswap_array_ssse3(unsigned char* dst, const unsigned char* src, std::size_t count) {
+    static constexpr auto mask_bytes = byteswap_shuffle_mask<Size>();
+    const auto            mask       = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask_bytes.data()));
+    const std::size_t     bytes      = count * Size;
+    std::size_t           i          = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask));
+    }
+    byteswap_array_scalar<Size>(dst + i, src + i, (bytes - i) / Size);
+}
+
+template <std::size_t Size>
+__attribute__((target("avx2"))) void byteswap_array_avx2(unsigned char* dst, const unsigned char* src, std::size_t count) {
+    // vpshufb shuffles within 128-bit lanes, so both lanes use the same mask
+    static constexpr auto mask_bytes = byteswap_shuffle_mask<Size>();
+    const auto mask = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask_bytes.data())));
+    const std::size_t bytes = count * Size;
+    std::size_t       i     = 0;
+    for (; i + 64 <= bytes; i += 64) {
+        auto v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        auto v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v0, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), _mm256_shuffle_epi8(v1, mask));
+    }
+    for (; i + 32 <= bytes; i += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v, mask));
+    }
+    byteswap_array_scalar<Size>(dst + i, src + i, (bytes - i) / Size);
+}
+
+#endif
+
+/** @brief Reverses the bytes of `count` elements of `Size` bytes each, from `src` to `dst`.
+ *
+ * `dst` and `src` may be equal (swapping in-place), but must not overlap otherwise.
+ * On x86, the fastest available kernel (AVX2, SSSE3 or scalar) is selected at runtime.
+ */
+template <std::size_t Size>
+void byteswap_array(void* dst, const void* src, std::size_t count) {
+    auto d = static_cast<unsigned char*>(dst);
+    auto s = static_cast<const unsigned char*>(src);
+    if constexpr (Size == 1) {
+        if (d != s && count > 0)
+            std::memcpy(d, s, count);
+        return;
+    } else {
+#ifdef GENERIC_FORMAT_X86_SIMD
+        switch (detected_simd_level()) {
+        case simd_level::avx2:
+            byteswap_array_avx2<Size>(d, s, count);
+            return;
+        case simd_level::ssse3:
+            byteswap_array_ssse3<Size>(d, s, count);
+            return;
+        case simd_level::none:
+            break;
+        }
+#endif
+        byteswap_array_scalar<Size>(d, s, count);
+    }
+}
+
+} // end namespace generic_format::detail
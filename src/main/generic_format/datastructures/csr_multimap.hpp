@@ -0,0 +1,252 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "generic_format/exceptions.hpp"
+#include "generic_format/mapping/container.hpp"
+
+namespace generic_format {
+namespace datastructures {
+
+namespace format {
+
+template <ast::IntegralFormat IndexFormat, ast::Format ValueFormat>
+struct csr_multimap_format;
+
+} // end namespace format
+
+template <class IndexType, class ValueType>
+requires std::is_integral<IndexType>::value
+class csr_multimap_builder;
+
+/** @brief A dense_multimap stored in compressed sparse row form.
+ *
+ * All values are stored in a single array, ordered by key, and row i spans the values between offsets i and i+1.
+ * This avoids one allocation per key, and rows can be scanned without indirections.
+ * The total number of values must fit into IndexType.
+ *
+ * put() is only cheap if the key is (at least) the largest key so far, use a csr_multimap_builder for bulk construction.
+ */
+template <class IndexType, class ValueType>
+requires std::is_integral<IndexType>::value
+    class csr_multimap {
+public:
+    using index_type = IndexType;
+    using value_type = ValueType;
+    using row_type   = std::span<const value_type>;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = row_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = row_type;
+
+        const_iterator() = default;
+
+        row_type operator*() const {
+            return (*_map)[_key];
+        }
+
+        const_iterator& operator++() {
+            ++_key;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++_key;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _key == other._key;
+        }
+
+    private:
+        friend class csr_multimap;
+
+        const_iterator(const csr_multimap* map, index_type key)
+            : _map(map)
+            , _key(key) { }
+
+        const csr_multimap* _map = nullptr;
+        index_type          _key = 0;
+    };
+
+    csr_multimap()
+        : _offsets{0} { }
+
+    void put(index_type key, const value_type& value) {
+        if (key >= size())
+            _offsets.resize(static_cast<std::size_t>(key) + 2, _offsets.back());
+        _values.insert(_values.begin() + _offsets[key + 1], value);
+        for (auto i = static_cast<std::size_t>(key) + 1; i < _offsets.size(); ++i)
+            ++_offsets[i];
+    }
+
+    void sort_values() {
+        for (std::size_t i = 0; i + 1 < _offsets.size(); ++i)
+            std::sort(_values.begin() + _offsets[i], _values.begin() + _offsets[i + 1]);
+    }
+
+    index_type size() const {
+        return static_cast<index_type>(_offsets.size() - 1);
+    }
+
+    /// The total number of values.
+    std::size_t number_of_values() const {
+        return _values.size();
+    }
+
+    const_iterator begin() const {
+        return {this, 0};
+    }
+
+    const_iterator end() const {
+        return {this, size()};
+    }
+
+    row_type operator[](index_type i) const {
+        return {_values.data() + _offsets[i], _values.data() + _offsets[i + 1]};
+    }
+
+private:
+    template <ast::IntegralFormat IndexFormat, ast::Format ValueFormat>
+    friend struct format::csr_multimap_format;
+
+    friend class csr_multimap_builder<IndexType, ValueType>;
+
+    std::vector<index_type> _offsets;
+    std::vector<value_type> _values;
+};
+
+/** @brief Collects key-value pairs, and builds a csr_multimap of them in linear time.
+ *
+ * Within a row, values keep their insertion order.
+ */
+template <class IndexType, class ValueType>
+requires std::is_integral<IndexType>::value
+    class csr_multimap_builder {
+public:
+    using index_type = IndexType;
+    using value_type = ValueType;
+
+    void reserve(std::size_t number_of_values) {
+        _keys.reserve(number_of_values);
+        _values.reserve(number_of_values);
+    }
+
+    void put(index_type key, const value_type& value) {
+        _keys.push_back(key);
+        _values.push_back(value);
+        if (key >= _number_of_rows)
+            _number_of_rows = static_cast<std::size_t>(key) + 1;
+    }
+
+    csr_multimap<index_type, value_type> build() const {
+        csr_multimap<index_type, value_type> result;
+        // counting sort: count the values per row, then place each value at the end of its row
+        auto& offsets = result._offsets;
+        offsets.assign(_number_of_rows + 1, 0);
+        for (auto key : _keys)
+            ++offsets[static_cast<std::size_t>(key) + 1];
+        for (std::size_t i = 1; i < offsets.size(); ++i)
+            offsets[i] += offsets[i - 1];
+        std::vector<index_type> positions(offsets.begin(), offsets.end() - 1);
+        result._values.resize(_values.size());
+        for (std::size_t i = 0; i < _keys.size(); ++i)
+            result._values[positions[_keys[i]]++] = _values[i];
+        return result;
+    }
+
+private:
+    std::vector<index_type> _keys;
+    std::vector<value_type> _values;
+    std::size_t             _number_of_rows = 0;
+};
+
+namespace format {
+
+template <ast::IntegralFormat IndexFormat, ast::Format ValueFormat>
+struct csr_multimap_format : generic_format::ast::base<generic_format::ast::format_list<IndexFormat, ValueFormat>> {
+    using index_format      = IndexFormat;
+    using value_format      = ValueFormat;
+    using native_index_type = typename IndexFormat::native_type;
+    using native_value_type = typename ValueFormat::native_type;
+
+    using native_type          = csr_multimap<native_index_type, native_value_type>;
+    static constexpr auto size = generic_format::ast::dynamic_size();
+
+    using offsets_format =
+        typename generic_format::ast::infer_format<decltype(dsl::container_format(index_format(), index_format())),
+                                                   std::vector<native_index_type>>::type;
+    using values_format =
+        typename generic_format::ast::infer_format<decltype(dsl::container_format(index_format(), value_format())),
+                                                   std::vector<native_value_type>>::type;
+
+    template <class RawWriter, class State>
+    void write(RawWriter& raw_writer, State& state, const native_type& t) const {
+        offsets_format().write(raw_writer, state, t._offsets);
+        values_format().write(raw_writer, state, t._values);
+    }
+
+    template <class State>
+    std::size_t measure(State& state, const native_type& t) const {
+        return offsets_format().measure(state, t._offsets) + values_format().measure(state, t._values);
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        offsets_format().skip(raw_reader, state);
+        values_format().skip(raw_reader, state);
+    }
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State& state, native_type& t) const {
+        // decode into local vectors, such that t stays consistent if the input is rejected
+        std::vector<native_index_type> offsets;
+        std::vector<native_value_type> values;
+        offsets_format().read(raw_reader, state, offsets);
+        values_format().read(raw_reader, state, values);
+        if (offsets.empty() || offsets.front() != 0 || offsets.back() != values.size() || !std::is_sorted(offsets.begin(), offsets.end()))
+            throw deserialization_exception();
+        t._offsets.swap(offsets);
+        t._values.swap(values);
+    }
+};
+
+} // end namespace format
+} // end namespace datastructures
+
+namespace dsl {
+
+/**
+ * @brief Serializer for a generic_format::datastructures::csr_multimap.
+ *
+ * The multimap will be encoded as two containers: the offsets of the rows, followed by all values.
+ * If both formats are raw primitives in native byte order, each container is read and written with a single copy.
+ *
+ * @param IndexFormat the type which is used to serialize the sizes of both containers and the offsets.
+ * @param ValueFormat the type which is used to serialize the values.
+ */
+template <ast::Format IndexFormat, ast::Format ValueFormat>
+constexpr datastructures::format::csr_multimap_format<IndexFormat, ValueFormat> csr_multimap_format(IndexFormat, ValueFormat) {
+    return {};
+}
+
+} // end namespace dsl
+} // end namespace generic_format
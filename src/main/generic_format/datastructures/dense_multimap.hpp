@@ -10,6 +10,7 @@
 
 #include <vector>
 
+#include "generic_format/ast/delta_bitpacked.hpp"
 #include "generic_format/mapping/container.hpp"
 
 namespace generic_format {
@@ -17,7 +18,12 @@ namespace datastructures {
 
 namespace format {
 
-template <ast::IntegralFormat IndexFormat, ast::Format ValueFormat>
+/// By default, a row is encoded as its number of items (via IndexFormat), followed by the items (via ValueFormat).
+template <class IndexFormat, class ValueFormat>
+using default_row_format = typename ast::infer_format<decltype(dsl::container_format(IndexFormat(), ValueFormat())),
+                                                      std::vector<typename ValueFormat::native_type>>::type;
+
+template <ast::IntegralFormat IndexFormat, ast::Format ValueFormat, ast::Format RowFormat = default_row_format<IndexFormat, ValueFormat>>
 struct dense_multimap_format;
 
 } // end namespace format
@@ -71,7 +77,7 @@ public:
     }
 
 private:
-    template <ast::Format IndexFormat, ast::Format ValueFormat>
+    template <ast::IntegralFormat IndexFormat, ast::Format ValueFormat, ast::Format RowFormat>
     friend struct format::dense_multimap_format;
 
     matrix_type _data;
@@ -79,16 +85,19 @@ private:
 
 namespace format {
 
-template <ast::IntegralFormat IndexFormat, ast::Format ValueFormat>
-struct dense_multimap_format : generic_format::ast::base<generic_format::ast::format_list<IndexFormat, ValueFormat>> {
+template <ast::IntegralFormat IndexFormat, ast::Format ValueFormat, ast::Format RowFormat>
+struct dense_multimap_format : generic_format::ast::base<generic_format::ast::format_list<IndexFormat, ValueFormat, RowFormat>> {
     using index_format       = IndexFormat;
     using value_format       = ValueFormat;
+    using row_format         = RowFormat;
     using native_index_type  = typename IndexFormat::native_type;
     using native_value_type  = typename ValueFormat::native_type;
-    using native_row_type    = std::vector<native_index_type>;
+    using native_row_type    = std::vector<native_value_type>;
     using native_matrix_type = std::vector<native_row_type>;
 
-    using matrix_format = decltype(dsl::container_format(index_format(), dsl::container_format(index_format(), value_format())));
+    static_assert(std::is_same<typename row_format::native_type, native_row_type>::value, "RowFormat must encode a row of values!");
+
+    using matrix_format = decltype(dsl::container_format(index_format(), row_format()));
 
     using native_type          = dense_multimap<native_index_type, native_value_type>;
     static constexpr auto size = generic_format::ast::dynamic_size();
@@ -100,6 +109,16 @@ struct dense_multimap_format : generic_format::ast::base<generic_format::ast::fo
         format().write(raw_writer, state, t._data);
     }
 
+    template <class State>
+    std::size_t measure(State& state, const native_type& t) const {
+        return format().measure(state, t._data);
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        format().skip(raw_reader, state);
+    }
+
     template <class RawReader, class State>
     void read(RawReader& raw_reader, State& state, native_type& t) const {
         format().read(raw_reader, state, t._data);
@@ -125,5 +144,19 @@ constexpr datastructures::format::dense_multimap_format<IndexFormat, ValueFormat
     return {};
 }
 
+/**
+ * @brief Compact serializer for a generic_format::datastructures::dense_multimap of 32-bit values, e.g. an inverted index.
+ *
+ * The multimap will be encoded as the numbers of rows, followed by the rows encoded via #delta_bitpacked_format.
+ * Rows should be sorted (see dense_multimap::sort_values()), otherwise they are still encoded correctly, but compress badly.
+ *
+ * @param IndexFormat the type which is used to serialize the number of rows and the number of items in a row.
+ */
+template <ast::Format IndexFormat>
+constexpr datastructures::format::dense_multimap_format<IndexFormat, ast::raw<std::uint32_t>, ast::delta_bitpacked<IndexFormat>>
+packed_dense_multimap_format(IndexFormat) {
+    return {};
+}
+
 } // end namespace dsl
 } // end namespace generic_format
@@ -11,17 +11,42 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <utility>
 
 #include "generic_format/ast/ast.hpp"
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/ast/skip.hpp"
+#include "generic_format/exceptions.hpp"
+#include "generic_format/mapping/container.hpp"
+#include "generic_format/parallel.hpp"
 
 namespace generic_format {
 namespace datastructures {
 
 namespace format {
-template <ast::IntegralFormat IndexFormat>
+
+/// By default, a row is encoded as its number of items, followed by the items (both via IndexFormat).
+template <class IndexFormat>
+using default_reversible_row_format = typename ast::infer_format<decltype(dsl::container_format(IndexFormat(), IndexFormat())),
+                                                                 std::vector<typename IndexFormat::native_type>>::type;
+
+template <ast::IntegralFormat IndexFormat,
+          ast::Format         RowFormat      = default_reversible_row_format<IndexFormat>,
+          unsigned            ReverseThreads = 1,
+          bool                PersistReverse = false>
 struct dense_reversible_multimap_format;
+
 } // end namespace format
 
+/// Tells when a dense_reversible_multimap builds its reverse rows.
+enum class reverse_index {
+    eager, ///< the reverse rows are maintained by each put
+    lazy   ///< the reverse rows are built on the first call to reverse(), and maintained afterwards
+};
+
 template <class IndexType>
 requires std::is_integral<IndexType>::value // TODO(sw) and must fit into size_t?
     class dense_reversible_multimap {
@@ -32,9 +57,10 @@ public:
     using matrix_type         = std::vector<row_type>;
     using const_iterator_type = typename matrix_type::iterator;
 
-    dense_reversible_multimap()
+    explicit dense_reversible_multimap(reverse_index mode = reverse_index::eager)
         : _forward(std::make_shared<matrix_type>())
-        , _reverse(std::make_shared<matrix_type>()) { }
+        , _reverse(std::make_shared<matrix_type>())
+        , _lazy_reverse(mode == reverse_index::lazy ? std::make_shared<lazy_reverse>() : nullptr) { }
 
     const row_type& operator[](index_type x) const {
         return (*_forward)[x];
@@ -44,6 +70,8 @@ public:
             _forward->resize(key + 1);
         (*_forward)[key].push_back(value);
 
+        if (!has_reverse())
+            return;
         if (value >= _reverse->size())
             (*_reverse).resize(value + 1);
         (*_reverse)[value].push_back(key);
@@ -53,10 +81,17 @@ public:
         return _forward->size();
     }
 
+    /// Returns a view of the reverse rows, sharing the storage with this multimap. In lazy mode, the first call builds the reverse rows.
     dense_reversible_multimap<index_type> reverse() const {
+        build_reverse();
         return {_reverse, _forward};
     }
 
+    /// Tells whether the reverse rows are available, i.e. the multimap is eager, or reverse() has already been called.
+    bool has_reverse() const {
+        return !_lazy_reverse || _lazy_reverse->built.load(std::memory_order_acquire);
+    }
+
     auto begin() const {
         return _forward->begin();
     }
@@ -72,54 +107,197 @@ public:
     }
 
 private:
-    template <ast::IntegralFormat IndexFormat>
+    template <ast::IntegralFormat IndexFormat, ast::Format RowFormat, unsigned ReverseThreads, bool PersistReverse>
     friend struct format::dense_reversible_multimap_format;
 
+    struct lazy_reverse {
+        std::once_flag    once;
+        std::atomic<bool> built{false};
+    };
+
     dense_reversible_multimap(std::shared_ptr<matrix_type> forward, std::shared_ptr<matrix_type> reverse)
         : _forward(forward)
         , _reverse(reverse) { }
 
-    std::shared_ptr<matrix_type> _forward;
-    std::shared_ptr<matrix_type> _reverse;
+    /** @brief Rebuilds the reverse rows from the forward rows.
+     *
+     * The forward rows are split into ranges of keys, one per thread. Each thread counts the values of its range,
+     * the counts are summed up per value to size the reverse rows exactly, and each thread then scatters the keys of its range
+     * to its own positions within the reverse rows. Thus, each forward row is visited twice in total, and the reverse rows
+     * are filled in order of the keys. All rows must only contain values below `number_of_values`.
+     */
+    void rebuild_reverse(std::size_t number_of_values, unsigned threads) const {
+        const auto& forward = *_forward;
+        auto&       reverse = *_reverse;
+        reverse.clear();
+        reverse.resize(number_of_values);
+        threads = std::max(1u, std::min(threads, static_cast<unsigned>(forward.size() / minimal_keys_per_thread)));
+
+        // positions[t][value] is the number of keys of range t with this value, and then the position of the next such key
+        std::vector<std::vector<std::size_t>> positions(threads);
+        const auto                            key_range = [&](unsigned t) {
+            return std::pair<std::size_t, std::size_t>(forward.size() * t / threads, forward.size() * (t + 1) / threads);
+        };
+        detail::parallel_for(threads, threads, [&](std::size_t first, std::size_t last) {
+            for (auto t = first; t < last; ++t) {
+                auto& counts = positions[t];
+                counts.assign(number_of_values, 0);
+                const auto [begin, end] = key_range(static_cast<unsigned>(t));
+                for (auto key = begin; key < end; ++key)
+                    for (auto value : forward[key])
+                        ++counts[value];
+            }
+        });
+        detail::parallel_for(number_of_values, threads, [&](std::size_t first, std::size_t last) {
+            for (auto value = first; value < last; ++value) {
+                std::size_t total = 0;
+                for (auto& counts : positions)
+                    total = std::exchange(counts[value], total) + total;
+                reverse[value].resize(total);
+            }
+        });
+        detail::parallel_for(threads, threads, [&](std::size_t first, std::size_t last) {
+            for (auto t = first; t < last; ++t) {
+                auto& next              = positions[t];
+                const auto [begin, end] = key_range(static_cast<unsigned>(t));
+                for (auto key = begin; key < end; ++key)
+                    for (auto value : forward[key])
+                        reverse[value][next[value]++] = static_cast<index_type>(key);
+            }
+        });
+    }
+
+    /// Builds the reverse rows once, if the multimap is lazy.
+    void build_reverse() const {
+        if (has_reverse())
+            return;
+        std::call_once(_lazy_reverse->once, [this] {
+            std::size_t number_of_values = 0;
+            for (const auto& row : *_forward)
+                for (auto value : row)
+                    number_of_values = std::max(number_of_values, static_cast<std::size_t>(value) + 1);
+            rebuild_reverse(number_of_values, 1);
+            mark_reverse_built();
+        });
+    }
+
+    /// Marks the reverse rows as available, if the multimap is lazy.
+    void mark_reverse_built() const {
+        if (_lazy_reverse)
+            _lazy_reverse->built.store(true, std::memory_order_release);
+    }
+
+    static constexpr std::size_t minimal_keys_per_thread = 1 << 12;
+
+    std::shared_ptr<matrix_type>  _forward;
+    std::shared_ptr<matrix_type>  _reverse;
+    std::shared_ptr<lazy_reverse> _lazy_reverse; // null if eager
 };
 
 namespace format {
 
-template <ast::IntegralFormat IndexFormat>
-
-struct dense_reversible_multimap_format : generic_format::ast::base<generic_format::ast::format_list<IndexFormat>> {
+/**
+ * Unless PersistReverse is set, the reverse rows are not serialized, but rebuilt after reading the forward rows
+ * (with ReverseThreads threads, 0 meaning one per hardware thread). A lazy multimap skips rebuilding until reverse() is called.
+ *
+ * If PersistReverse is set, the reverse rows are serialized after the forward rows, and are available right after reading.
+ */
+template <ast::IntegralFormat IndexFormat, ast::Format RowFormat, unsigned ReverseThreads, bool PersistReverse>
+struct dense_reversible_multimap_format : generic_format::ast::base<generic_format::ast::format_list<IndexFormat, RowFormat>> {
     using index_format      = IndexFormat;
+    using row_format        = RowFormat;
     using native_index_type = typename index_format::native_type;
 
     using native_type          = dense_reversible_multimap<native_index_type>;
     static constexpr auto size = generic_format::ast::dynamic_size();
 
+    static_assert(std::is_same<typename row_format::native_type, typename native_type::row_type>::value,
+                  "RowFormat must encode a row of indices!");
+
     template <class RawWriter, class State>
     void write(RawWriter& raw_writer, State& state, const native_type& t) const {
-        // TODO(sw) verify integer overflow
-        index_format().write(raw_writer, state, static_cast<native_index_type>(t._forward->size()));
-        for (const auto& row : *t._forward) {
-            // TODO(sw) verify integer overflow
-            index_format().write(raw_writer, state, static_cast<native_index_type>(row.size()));
-            for (auto v : row) {
-                index_format().write(raw_writer, state, v);
-            }
+        write_rows(raw_writer, state, *t._forward);
+        if constexpr (PersistReverse) {
+            t.build_reverse();
+            write_rows(raw_writer, state, *t._reverse);
         }
     }
 
+    template <class State>
+    std::size_t measure(State& state, const native_type& t) const {
+        auto result = measure_rows(state, *t._forward);
+        if constexpr (PersistReverse) {
+            t.build_reverse();
+            result += measure_rows(state, *t._reverse);
+        }
+        return result;
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        skip_rows(raw_reader, state);
+        if constexpr (PersistReverse)
+            skip_rows(raw_reader, state);
+    }
+
     template <class RawReader, class State>
     void read(RawReader& raw_reader, State& state, native_type& t) const {
+        auto number_of_values = read_rows(raw_reader, state, *t._forward);
+        if constexpr (PersistReverse) {
+            auto number_of_keys = read_rows(raw_reader, state, *t._reverse);
+            if (number_of_keys > t._forward->size() || number_of_values > t._reverse->size())
+                throw deserialization_exception();
+            t.mark_reverse_built();
+        } else if (t.has_reverse()) {
+            t.rebuild_reverse(number_of_values, detail::thread_count(ReverseThreads));
+        }
+    }
+
+private:
+    using matrix_type = typename native_type::matrix_type;
+
+    template <class RawWriter, class State>
+    static void write_rows(RawWriter& raw_writer, State& state, const matrix_type& rows) {
+        // TODO(sw) verify integer overflow
+        index_format().write(raw_writer, state, static_cast<native_index_type>(rows.size()));
+        for (const auto& row : rows) {
+            row_format().write(raw_writer, state, row);
+        }
+    }
+
+    template <class State>
+    static std::size_t measure_rows(State& state, const matrix_type& rows) {
+        auto result = generic_format::ast::measure<index_format>(state, static_cast<native_index_type>(rows.size()));
+        for (const auto& row : rows)
+            result += generic_format::ast::measure<row_format>(state, row);
+        return result;
+    }
+
+    template <class RawReader, class State>
+    static void skip_rows(RawReader& raw_reader, State& state) {
         native_index_type nRows;
         index_format().read(raw_reader, state, nRows);
-        for (native_index_type i = 0; i < nRows; ++i) {
-            native_index_type n;
-            index_format().read(raw_reader, state, n);
-            for (native_index_type j = 0; j < n; ++j) {
-                native_index_type v;
-                index_format().read(raw_reader, state, v);
-                t.put(i, v); // TODO(sw) can be optimized
+        for (native_index_type i = 0; i < nRows; ++i)
+            generic_format::ast::skip<row_format>(raw_reader, state);
+    }
+
+    /// Reads rows in place, and returns the largest value plus one.
+    template <class RawReader, class State>
+    static std::size_t read_rows(RawReader& raw_reader, State& state, matrix_type& rows) {
+        native_index_type nRows;
+        index_format().read(raw_reader, state, nRows);
+        rows.resize(nRows);
+        std::size_t number_of_values = 0;
+        for (auto& row : rows) {
+            row_format().read(raw_reader, state, row);
+            for (auto v : row) {
+                if constexpr (std::is_signed<native_index_type>::value)
+                    if (v < 0)
+                        throw deserialization_exception();
+                number_of_values = std::max(number_of_values, static_cast<std::size_t>(v) + 1);
             }
         }
+        return number_of_values;
     }
 };
 
@@ -143,5 +321,43 @@ constexpr datastructures::format::dense_reversible_multimap_format<IndexFormat>
     return {};
 }
 
+/**
+ * @brief Same as #dense_reversible_multimap_format, but rebuilds the reverse rows in parallel after reading.
+ *
+ * @param ReverseThreads the number of threads, 0 meaning one per hardware thread.
+ */
+template <unsigned ReverseThreads, ast::Format IndexFormat>
+constexpr datastructures::format::dense_reversible_multimap_format<IndexFormat,
+                                                                   datastructures::format::default_reversible_row_format<IndexFormat>,
+                                                                   ReverseThreads>
+parallel_dense_reversible_multimap_format(IndexFormat) {
+    return {};
+}
+
+/**
+ * @brief Same as #dense_reversible_multimap_format, but also encodes the reverse rows (in the same way), such that they need not be rebuilt
+ * after reading.
+ */
+template <ast::Format IndexFormat>
+constexpr datastructures::format::
+    dense_reversible_multimap_format<IndexFormat, datastructures::format::default_reversible_row_format<IndexFormat>, 1, true>
+    dense_reversible_multimap_with_reverse_format(IndexFormat) {
+    return {};
+}
+
+/**
+ * @brief Compact serializer for a generic_format::datastructures::dense_reversible_multimap of 32-bit indices.
+ *
+ * The multimap will be encoded in its front representation, as the numbers of rows, followed by the rows encoded
+ * via #delta_bitpacked_format. Rows should be sorted (see dense_reversible_multimap::sortValues()).
+ *
+ * @param IndexFormat the type which is used to serialize the number of rows and the number of items in a row.
+ */
+template <ast::Format IndexFormat>
+constexpr datastructures::format::dense_reversible_multimap_format<IndexFormat, ast::delta_bitpacked<IndexFormat>>
+packed_dense_reversible_multimap_format(IndexFormat) {
+    return {};
+}
+
 } // end namespace dsl
 } // end namespace generic_format
@@ -64,6 +64,40 @@ constexpr ast::string<LengthFormat> string_format(LengthFormat) {
     return {};
 }
 
+/**
+ * @brief Serializer for a string, which is deserialized into a std::string_view.
+ *
+ * The encoding is the same as for #string_format. When reading from a target with contiguous storage (e.g. memory or a memory mapped
+ * file), the view points into that storage and no allocation happens. Other targets copy the data into an arena owned by the reader.
+ * @param LengthType the type which is used to serialize the length.
+ */
+template <ast::Format LengthFormat>
+constexpr ast::string_view<LengthFormat> string_view_format(LengthFormat) {
+    return {};
+}
+
+/**
+ * @brief Format for a std::vector<std::uint32_t>, which is delta-encoded and bit-packed in blocks of 128 values.
+ *
+ * Sorted vectors (e.g. posting lists) compress well, other vectors are still encoded correctly.
+ * @param LengthType the type which is used to serialize the length.
+ */
+template <ast::Format LengthFormat>
+constexpr ast::delta_bitpacked<LengthFormat> delta_bitpacked_format(LengthFormat) {
+    return {};
+}
+
+/**
+ * @brief Format for a std::vector<std::uint32_t>, which is stored in the Stream VByte layout.
+ *
+ * Prefer this over a container of LEB128 values when decoding speed matters and the values have mixed lengths.
+ * @param LengthType the type which is used to serialize the length.
+ */
+template <ast::Format LengthFormat>
+constexpr ast::stream_vbyte<LengthFormat> stream_vbyte_format(LengthFormat) {
+    return {};
+}
+
 /** @brief A placeholder which is also a factory for new placeholders.
  *
  * This can be quite handy if you need to nest or reuse formats.
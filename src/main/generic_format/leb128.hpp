@@ -0,0 +1,297 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "generic_format/byteswap.hpp"
+#include "generic_format/simd.hpp"
+
+
+namespace generic_format::detail {
+
+/// Maximal number of bytes of an LEB128-encoded value of type T.
+template <class T>
+constexpr std::size_t leb128_max_size = (sizeof(T) * 8 + 6) / 7;
+
+/// The number of bytes of the LEB128 encoding of an unsigned integer.
+template <class T>
+constexpr std::size_t leb128_size(T value) {
+    static_assert(std::is_unsigned<T>::value, "LEB128 encodes unsigned integers!");
+    return value < 0x80 ? 1 : (static_cast<std::size_t>(std::bit_width(value)) + 6) / 7;
+}
+
+/// Encodes an unsigned integer into `out`, which must provide leb128_max_size<T> bytes, and returns the number of bytes used.
+template <class T>
+std::size_t leb128_encode(T value, unsigned char* out) {
+    static_assert(std::is_unsigned<T>::value, "LEB128 encodes unsigned integers!");
+    std::size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<unsigned char>(value);
+    return n;
+}
+
+/// Decodes a value of `length` bytes, the last of which has no continuation bit. Returns false on overflow.
+template <class T>
+bool leb128_decode_known_length(const unsigned char* p, std::size_t length, T& value) {
+    constexpr auto max_size = leb128_max_size<T>;
+    if (length > max_size)
+        return false;
+    T result = 0;
+    for (std::size_t i = 0; i < length; ++i)
+        result |= static_cast<T>(static_cast<T>(p[i] & 0x7f) << (7 * i));
+    // the last byte of a maximal-length encoding must not carry bits beyond the width of T
+    if (length == max_size && (p[length - 1] >> (sizeof(T) * 8 - 7 * (max_size - 1))) != 0)
+        return false;
+    value = result;
+    return true;
+}
+
+/// Decodes a single value from [p, end). Returns the end of the encoded value, or nullptr if it is truncated or overflows.
+template <class T>
+const unsigned char* leb128_decode(const unsigned char* p, const unsigned char* end, T& value) {
+    static_assert(std::is_unsigned<T>::value, "LEB128 encodes unsigned integers!");
+    for (std::size_t length = 1; length <= leb128_max_size<T> && p + length <= end; ++length) {
+        if ((p[length - 1] & 0x80) == 0)
+            return leb128_decode_known_length(p, length, value) ? p + length : nullptr;
+    }
+    return nullptr;
+}
+
+/** @brief Decodes a value of `length` bytes (at most 8) from 8 readable bytes at `p`, without branches on the length.
+ *
+ * The 7-bit groups are compacted by shifts and masks, doubling the group width in each step.
+ */
+inline std::uint64_t leb128_decode_compact(const unsigned char* p, std::size_t length) {
+    std::uint64_t x;
+    std::memcpy(&x, p, sizeof(x));
+    if constexpr (std::endian::native == std::endian::big)
+        x = byteswap(x);
+    x &= ~std::uint64_t{0} >> (64 - 8 * length);
+    x = ((x & 0x7f007f007f007f00) >> 1) | (x & 0x007f007f007f007f);
+    x = ((x & 0x3fff00003fff0000) >> 2) | (x & 0x00003fff00003fff);
+    x = ((x & 0x0fffffff00000000) >> 4) | (x & 0x000000000fffffff);
+    return x;
+}
+
+/** @brief Decodes the values which end within the 16 bytes at `p`, given their terminator bits (the inverted continuation bits).
+ *
+ * At least 24 bytes must be readable at `p`. Returns false if the input is malformed.
+ */
+template <class T>
+bool leb128_decode_window(const unsigned char*& p, const unsigned char* end, unsigned terminators, T*& out, std::size_t& count) {
+    if (terminators == 0) {
+        // a value spanning more than the window is invalid for 32 bit, but possible for 64 bit
+        if (!(p = leb128_decode(p, end, *out)))
+            return false;
+        ++out;
+        --count;
+        return true;
+    }
+    unsigned start = 0;
+    while (terminators != 0 && count > 0) {
+        auto last   = static_cast<unsigned>(std::countr_zero(terminators));
+        auto length = last - start + 1;
+        if (length < leb128_max_size<T> && length <= 8) {
+            *out = static_cast<T>(leb128_decode_compact(p + start, length));
+        } else if (!leb128_decode_known_length(p + start, length, *out)) {
+            return false;
+        }
+        ++out;
+        --count;
+        start = last + 1;
+        terminators &= terminators - 1;
+    }
+    p += start;
+    return true;
+}
+
+#ifdef GENERIC_FORMAT_X86_SIMD
+
+/** @brief Shuffle which moves the bytes of the first values of a window into lanes of 2 or 4 bytes, as in masked VByte.
+ *
+ * Indexed by the continuation bits of the first 12 bytes of a window. If the first 6 values take at most 2 bytes each,
+ * they are moved into 16-bit lanes, else if the first 4 values take at most 3 bytes each, they are moved into 32-bit lanes.
+ * Otherwise `values` is 0.
+ */
+struct leb128_shuffle {
+    unsigned char        values;
+    unsigned char        consumed;
+    std::array<char, 16> pattern;
+};
+
+constexpr std::array<leb128_shuffle, 4096> make_leb128_shuffle_table() {
+    std::array<leb128_shuffle, 4096> table{};
+    for (unsigned mask = 0; mask < 4096; ++mask) {
+        unsigned lengths[12]{};
+        unsigned n     = 0;
+        unsigned start = 0;
+        for (unsigned i = 0; i < 12; ++i) {
+            if (((mask >> i) & 1) == 0) {
+                lengths[n++] = i - start + 1;
+                start        = i + 1;
+            }
+        }
+        auto fits = [&](unsigned values, unsigned max_length) {
+            if (n < values)
+                return false;
+            for (unsigned k = 0; k < values; ++k)
+                if (lengths[k] > max_length)
+                    return false;
+            return true;
+        };
+        unsigned values, lane;
+        if (fits(6, 2)) {
+            values = 6;
+            lane   = 2;
+        } else if (fits(4, 3)) {
+            values = 4;
+            lane   = 4;
+        } else {
+            continue;
+        }
+        auto& entry = table[mask];
+        for (auto& index : entry.pattern)
+            index = static_cast<char>(0x80); // zeroes the byte
+        unsigned position = 0;
+        for (unsigned k = 0; k < values; ++k) {
+            for (unsigned b = 0; b < lengths[k]; ++b)
+                entry.pattern[k * lane + b] = static_cast<char>(position + b);
+            position += lengths[k];
+        }
+        entry.values   = static_cast<unsigned char>(values);
+        entry.consumed = static_cast<unsigned char>(position);
+    }
+    return table;
+}
+
+inline constexpr auto leb128_shuffle_table = make_leb128_shuffle_table();
+
+/// Zero-extends 16 single-byte values.
+template <class T>
+__attribute__((target("ssse3"))) void leb128_widen_16(__m128i bytes, T* out) {
+    const auto zero = _mm_setzero_si128();
+    auto       lo16 = _mm_unpacklo_epi8(bytes, zero);
+    auto       hi16 = _mm_unpackhi_epi8(bytes, zero);
+    if constexpr (sizeof(T) == 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo16, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(lo16, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(hi16, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(hi16, zero));
+    } else {
+        __m128i words[4] = {_mm_unpacklo_epi16(lo16, zero),
+                            _mm_unpackhi_epi16(lo16, zero),
+                            _mm_unpacklo_epi16(hi16, zero),
+                            _mm_unpackhi_epi16(hi16, zero)};
+        for (int i = 0; i < 4; ++i) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i), _mm_unpacklo_epi32(words[i], zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i + 2), _mm_unpackhi_epi32(words[i], zero));
+        }
+    }
+}
+
+/// Decodes windows of 16 bytes while at least 16 values remain, and returns the position of the first value not decoded.
+template <class T>
+__attribute__((target("ssse3"))) const unsigned char* leb128_decode_windows_ssse3(const unsigned char* p,
+                                                                                  const unsigned char* end,
+                                                                                  T*&                  out,
+                                                                                  std::size_t&         count) {
+    const auto low7 = _mm_set1_epi32(0x7f);
+    // values are read as 8 bytes at their start, which stays within the input given 8 bytes beyond the window
+    while (count >= 16 && end - p >= 24) {
+        auto bytes        = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        auto continuation = static_cast<unsigned>(_mm_movemask_epi8(bytes));
+        if (continuation == 0) {
+            leb128_widen_16(bytes, out);
+            p += 16;
+            out += 16;
+            count -= 16;
+            continue;
+        }
+        if constexpr (sizeof(T) == 4) {
+            const auto& shuffle = leb128_shuffle_table[continuation & 0xfff];
+            if (shuffle.values != 0) {
+                auto lanes = _mm_shuffle_epi8(bytes, _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle.pattern.data())));
+                if (shuffle.values == 6) {
+                    auto decoded = _mm_or_si128(_mm_and_si128(lanes, _mm_set1_epi16(0x7f)),
+                                                _mm_srli_epi16(_mm_and_si128(lanes, _mm_set1_epi16(0x7f00)), 1));
+                    // 8 values are stored, of which the last 2 are overwritten later
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(decoded, _mm_setzero_si128()));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(decoded, _mm_setzero_si128()));
+                } else {
+                    auto decoded = _mm_or_si128(_mm_or_si128(_mm_and_si128(lanes, low7),
+                                                             _mm_srli_epi32(_mm_and_si128(lanes, _mm_slli_epi32(low7, 8)), 1)),
+                                                _mm_srli_epi32(_mm_and_si128(lanes, _mm_slli_epi32(low7, 16)), 2));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), decoded);
+                }
+                p += shuffle.consumed;
+                out += shuffle.values;
+                count -= shuffle.values;
+                continue;
+            }
+        }
+        if (!leb128_decode_window(p, end, ~continuation & 0xffffu, out, count))
+            return nullptr;
+    }
+    return p;
+}
+
+#endif
+
+/** @brief Decodes `count` values from [p, end) into `out`.
+ *
+ * Returns the end of the last encoded value, or nullptr if the input is truncated or malformed.
+ * On x86 with SSSE3, windows of 16 bytes are classified at once by their continuation bits: windows of single-byte values
+ * are widened, 32-bit values of up to 3 bytes are decoded by a table-driven shuffle (as in masked VByte), and in all other
+ * windows the values are decoded at the known boundaries.
+ *
+ * Single-byte values decode at about 2.8 GB/s of input, but each window depends on the length of the previous one, so values
+ * of 1-2 and 1-3 bytes only reach about 0.6-0.8 GB/s, and values of up to 5 bytes about 0.3 GB/s (see src/examples/benchmark.cpp).
+ * For 32-bit values of mixed lengths, dsl::stream_vbyte_format decodes at more than 1 GB/s.
+ */
+template <class T>
+const unsigned char* leb128_decode_batch(const unsigned char* p, const unsigned char* end, T* out, std::size_t count) {
+    static_assert(std::is_unsigned<T>::value, "LEB128 encodes unsigned integers!");
+#ifdef GENERIC_FORMAT_X86_SIMD
+    if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+        if (detected_simd_level() != simd_level::none) {
+            if (!(p = leb128_decode_windows_ssse3(p, end, out, count)))
+                return nullptr;
+        }
+    }
+#endif
+    for (; count > 0; --count) {
+        if (!(p = leb128_decode(p, end, *out++)))
+            return nullptr;
+    }
+    return p;
+}
+
+/// Maps signed integers to unsigned integers, such that values of small magnitude have small encodings.
+template <class T>
+constexpr std::make_unsigned_t<T> zigzag_encode(T value) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<U>(static_cast<U>(value) << 1) ^ static_cast<U>(value >> (sizeof(T) * 8 - 1));
+}
+
+template <class T>
+constexpr T zigzag_decode(std::make_unsigned_t<T> value) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(value >> 1) ^ static_cast<U>(U{0} - (value & 1)));
+}
+
+} // end namespace generic_format::detail
@@ -0,0 +1,141 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "generic_format/parallel.hpp"
+
+namespace generic_format::lookup::impl {
+
+/** @brief A vector which only grows, and whose elements can be read while another thread appends.
+ *
+ * The elements are stored in segments of doubling size, which are never moved, such that references stay valid.
+ * A single writer at a time may call push_back(), any number of readers may concurrently call size() and operator[]
+ * (for indices below size()) without locking: the size is published after the element has been constructed.
+ * Many elements can be appended at once by several threads, see append().
+ */
+template <class T>
+class append_only_vector {
+public:
+    using value_type = T;
+
+    append_only_vector() = default;
+
+    append_only_vector(const append_only_vector&)            = delete;
+    append_only_vector& operator=(const append_only_vector&) = delete;
+
+    ~append_only_vector() {
+        destroy(0, _size.load(std::memory_order_relaxed));
+        for (std::size_t s = 0; s < max_segments; ++s)
+            if (_segments[s])
+                std::allocator<T>().deallocate(_segments[s], segment_size(s));
+    }
+
+    std::size_t size() const {
+        return _size.load(std::memory_order_acquire);
+    }
+
+    const T& operator[](std::size_t index) const {
+        auto [segment, offset] = locate(index);
+        return _segments[segment][offset];
+    }
+
+    T& operator[](std::size_t index) {
+        auto [segment, offset] = locate(index);
+        return _segments[segment][offset];
+    }
+
+    /// Appends an element, must not be called concurrently with another push_back().
+    void push_back(const T& value) {
+        const auto index       = _size.load(std::memory_order_relaxed);
+        auto [segment, offset] = locate(index);
+        if (!_segments[segment])
+            _segments[segment] = std::allocator<T>().allocate(segment_size(segment));
+        std::construct_at(_segments[segment] + offset, value);
+        _size.store(index + 1, std::memory_order_release);
+    }
+
+    /** @brief Appends `count` elements, the i-th one being constructed from `value_at(i)`, using up to `threads` threads.
+     *
+     * Must not be called concurrently with another writer. The elements become visible to readers all at once.
+     * If a construction throws, no element is appended.
+     */
+    template <class Function>
+    void append(std::size_t count, unsigned threads, Function&& value_at) {
+        const auto first = _size.load(std::memory_order_relaxed);
+        if (count == 0)
+            return;
+        for (auto segment = locate(first).segment; segment <= locate(first + count - 1).segment; ++segment)
+            if (!_segments[segment])
+                _segments[segment] = std::allocator<T>().allocate(segment_size(segment));
+
+        std::mutex                                       completed_mutex;
+        std::vector<std::pair<std::size_t, std::size_t>> completed; // ranges to roll back if another range fails
+        completed.reserve(std::max(1u, threads));
+        try {
+            detail::parallel_for(count, threads, [&](std::size_t begin, std::size_t end) {
+                std::size_t i = begin;
+                try {
+                    for (; i < end; ++i)
+                        std::construct_at(&(*this)[first + i], value_at(i));
+                } catch (...) {
+                    destroy(first + begin, first + i);
+                    throw;
+                }
+                std::lock_guard lock(completed_mutex);
+                completed.emplace_back(begin, end);
+            });
+        } catch (...) {
+            for (auto [begin, end] : completed)
+                destroy(first + begin, first + end);
+            throw;
+        }
+        _size.store(first + count, std::memory_order_release);
+    }
+
+private:
+    static constexpr std::size_t first_segment_bits = 6;
+    static constexpr std::size_t max_segments       = sizeof(std::size_t) * 8 - first_segment_bits;
+
+    static constexpr std::size_t segment_size(std::size_t segment) {
+        return std::size_t{1} << (segment + first_segment_bits);
+    }
+
+    struct location {
+        std::size_t segment;
+        std::size_t offset;
+    };
+
+    /// Segment s holds the indices from segment_size(s) - segment_size(0) on.
+    static location locate(std::size_t index) {
+        const auto biased  = index + segment_size(0);
+        const auto segment = static_cast<std::size_t>(std::bit_width(biased)) - 1 - first_segment_bits;
+        assert(segment < max_segments);
+        return {segment, biased - segment_size(segment)};
+    }
+
+    void destroy(std::size_t first, std::size_t last) {
+        for (auto i = first; i < last; ++i)
+            std::destroy_at(&(*this)[i]);
+    }
+
+    T*                       _segments[max_segments]{};
+    std::atomic<std::size_t> _size{0};
+};
+
+} // end namespace generic_format::lookup::impl
@@ -0,0 +1,553 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "generic_format/ast/base.hpp"
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/byteswap.hpp"
+#include "generic_format/exceptions.hpp"
+
+namespace generic_format::lookup {
+
+namespace impl {
+
+/// Finalizer of splitmix64.
+constexpr std::uint64_t mix64(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/// A hash of bytes, which does not depend on the platform, such that it can be persisted.
+inline std::uint64_t hash_bytes(const unsigned char* data, std::size_t size, std::uint64_t seed) {
+    std::uint64_t h = seed ^ (size * 0x9e3779b97f4a7c15ULL);
+    for (; size >= 8; data += 8, size -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data, 8);
+        if constexpr (std::endian::native == std::endian::big)
+            word = generic_format::detail::byteswap(word);
+        h = mix64(h ^ word);
+    }
+    if (size > 0) {
+        std::uint64_t word = 0;
+        for (std::size_t i = 0; i < size; ++i)
+            word |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+        h = mix64(h ^ word);
+    }
+    return mix64(h);
+}
+
+/// Maps a 32-bit hash uniformly to [0, n).
+constexpr std::uint64_t reduce(std::uint64_t hash32, std::uint64_t n) {
+    return (hash32 * n) >> 32;
+}
+
+/** @brief Describes how values are stored in the arena of a frozen_lookup_table.
+ *
+ * `bytes(v)` returns the bytes of a value (as something with data() and size()), `decode()` restores a value from its bytes,
+ * and values of a non-zero `fixed_size` need no offsets.
+ */
+template <class T>
+struct frozen_value;
+
+template <>
+struct frozen_value<std::string> {
+    using view_type                         = std::string_view;
+    static constexpr std::size_t fixed_size = 0;
+
+    static std::string_view bytes(std::string_view v) {
+        return v;
+    }
+
+    static view_type decode(const unsigned char* data, std::size_t size) {
+        return {reinterpret_cast<const char*>(data), size};
+    }
+};
+
+/// Integers are stored in little endian.
+template <std::integral T>
+struct frozen_value<T> {
+    using view_type                         = T;
+    static constexpr std::size_t fixed_size = sizeof(T);
+
+    static std::array<unsigned char, sizeof(T)> bytes(T v) {
+        if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1)
+            v = generic_format::detail::byteswap(v);
+        std::array<unsigned char, sizeof(T)> result;
+        std::memcpy(result.data(), &v, sizeof(T));
+        return result;
+    }
+
+    static view_type decode(const unsigned char* data, std::size_t) {
+        T v;
+        std::memcpy(&v, data, sizeof(T));
+        if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1)
+            v = generic_format::detail::byteswap(v);
+        return v;
+    }
+};
+
+} // end namespace impl
+
+template <class IdType, class ValueType, bool borrow>
+struct frozen_lookup_table_format;
+
+/** @brief An immutable lookup table, which maps values to ids via a minimal perfect hash function.
+ *
+ * The values are stored in a single arena (strings or integers are supported), and are looked up without locking:
+ * lookup_by_value() computes a single hash and compares a single value.
+ *
+ * The perfect hash follows the hash-and-displace scheme (CHD): each value hashes to a bucket of about 2 values,
+ * and each bucket stores a displacement chosen such that all values get distinct slots. Buckets of a single value
+ * store their slot directly. Each slot stores the id of its value.
+ *
+ * All data lives in a single block of memory, whose layout is also the serialized layout (see frozen_lookup_table_format),
+ * such that reading does not rebuild anything, and can even refer to a memory mapped file instead of copying.
+ */
+template <class IdType, class ValueType>
+class frozen_lookup_table {
+    using traits = impl::frozen_value<ValueType>;
+
+public:
+    using id_type    = IdType;
+    using value_type = ValueType;
+    using view_type  = typename traits::view_type;
+
+    /// An empty table.
+    frozen_lookup_table() {
+        attach_owned(layout_of(0, 0, 0, 0));
+    }
+
+    /// Builds a table, the id of a value is its index.
+    template <class Range>
+    explicit frozen_lookup_table(const Range& values) {
+        build(values);
+    }
+
+    frozen_lookup_table(const frozen_lookup_table&)            = delete;
+    frozen_lookup_table& operator=(const frozen_lookup_table&) = delete;
+    frozen_lookup_table(frozen_lookup_table&&)                 = default;
+    frozen_lookup_table& operator=(frozen_lookup_table&&)      = default;
+
+    std::size_t size() const {
+        return _ids.size();
+    }
+
+    /// Maps an id (which must be smaller than size()) to a value.
+    view_type lookup_by_id(id_type id) const {
+        return traits::decode(_arena.data() + begin_of(id), size_of(id));
+    }
+
+    /// Maps a value to its id, if it exists.
+    std::optional<id_type> lookup_by_value(view_type value) const {
+        if (_ids.empty())
+            return std::nullopt;
+        const auto bytes = traits::bytes(value);
+        const auto data  = reinterpret_cast<const unsigned char*>(bytes.data());
+        const auto id    = _ids[slot_of(impl::hash_bytes(data, bytes.size(), _header.seed))];
+        if (size_of(id) != bytes.size() || std::memcmp(_arena.data() + begin_of(id), data, bytes.size()) != 0)
+            return std::nullopt;
+        return id;
+    }
+
+    /// Tells whether the table refers to external memory (see frozen_lookup_table_view_format), instead of owning its memory.
+    bool is_borrowed() const {
+        return _storage.empty();
+    }
+
+private:
+    template <class, class, bool>
+    friend struct frozen_lookup_table_format;
+
+    struct header {
+        std::uint64_t number_of_values;
+        std::uint64_t number_of_buckets;
+        std::uint64_t seed;
+        std::uint64_t arena_size;
+    };
+    static_assert(sizeof(header) == 4 * sizeof(std::uint64_t));
+
+    /// Byte offsets of the sections of the storage.
+    struct layout {
+        header      head;
+        std::size_t offsets;
+        std::size_t ids;
+        std::size_t displacements;
+        std::size_t arena;
+        std::size_t size;
+    };
+
+    static constexpr bool          has_offsets      = traits::fixed_size == 0;
+    static constexpr std::size_t   bucket_size      = 2;
+    static constexpr std::uint32_t direct_slot      = std::uint32_t{1} << 31; // flags a displacement which is a slot
+    static constexpr std::uint32_t max_displacement = std::uint32_t{1} << 24; // before trying another seed
+    static constexpr std::uint64_t max_seeds        = 64;                     // before giving up
+
+    /// Computes the layout, where sections are ordered by decreasing alignment.
+    static layout layout_of(std::uint64_t number_of_values, std::uint64_t number_of_buckets, std::uint64_t seed, std::uint64_t arena_size) {
+        constexpr auto limit = std::numeric_limits<std::size_t>::max() / 16;
+        if (number_of_values >= direct_slot || number_of_buckets > number_of_values + 1 || arena_size > limit)
+            throw deserialization_exception();
+        layout result{{number_of_values, number_of_buckets, seed, arena_size}, 0, 0, 0, 0, 0};
+        std::size_t position = sizeof(header);
+        result.offsets       = position;
+        if constexpr (has_offsets)
+            position += (number_of_values + 1) * sizeof(std::uint64_t);
+        if constexpr (alignof(id_type) >= alignof(std::uint32_t)) {
+            result.ids = position;
+            position += number_of_values * sizeof(id_type);
+            result.displacements = position;
+            position += number_of_buckets * sizeof(std::uint32_t);
+        } else {
+            result.displacements = position;
+            position += number_of_buckets * sizeof(std::uint32_t);
+            result.ids = position;
+            position += number_of_values * sizeof(id_type);
+        }
+        result.arena = position;
+        result.size  = position + arena_size;
+        return result;
+    }
+
+    /// Allocates owned storage for a layout, and points the sections into it.
+    void attach_owned(const layout& l) {
+        _storage.assign((l.size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t), 0);
+        std::memcpy(_storage.data(), &l.head, sizeof(header));
+        attach(reinterpret_cast<unsigned char*>(_storage.data()), l);
+    }
+
+    void attach(const unsigned char* data, const layout& l) {
+        _data          = data;
+        _header        = l.head;
+        _offsets       = {reinterpret_cast<const std::uint64_t*>(data + l.offsets), has_offsets ? l.head.number_of_values + 1 : 0};
+        _ids           = {reinterpret_cast<const id_type*>(data + l.ids), l.head.number_of_values};
+        _displacements = {reinterpret_cast<const std::uint32_t*>(data + l.displacements), l.head.number_of_buckets};
+        _arena         = {data + l.arena, l.head.arena_size};
+    }
+
+    /// Checks that the storage refers to valid positions only, and that all values are found again.
+    void validate() const {
+        const auto n = _ids.size();
+        if (n > 0 && _displacements.empty())
+            throw deserialization_exception();
+        if constexpr (has_offsets) {
+            if (_offsets[0] != 0 || _offsets[n] != _arena.size() || !std::is_sorted(_offsets.begin(), _offsets.end()))
+                throw deserialization_exception();
+        } else {
+            if (_arena.size() != n * traits::fixed_size)
+                throw deserialization_exception();
+        }
+        for (auto d : _displacements)
+            if ((d & direct_slot) != 0 && (d & ~direct_slot) >= n)
+                throw deserialization_exception();
+        for (auto id : _ids)
+            if (static_cast<std::uint64_t>(id) >= n)
+                throw deserialization_exception();
+    }
+
+    std::size_t begin_of(id_type id) const {
+        if constexpr (has_offsets)
+            return _offsets[id];
+        else
+            return static_cast<std::size_t>(id) * traits::fixed_size;
+    }
+
+    std::size_t size_of(id_type id) const {
+        if constexpr (has_offsets)
+            return _offsets[id + 1] - _offsets[id];
+        else
+            return traits::fixed_size;
+    }
+
+    static std::uint64_t bucket_of(std::uint64_t hash, std::uint64_t number_of_buckets) {
+        return impl::reduce(hash >> 32, number_of_buckets);
+    }
+
+    static std::uint64_t displaced_slot(std::uint64_t hash, std::uint32_t displacement, std::uint64_t n) {
+        return impl::reduce(impl::mix64(hash + displacement * 0x9e3779b97f4a7c15ULL) & 0xffffffffULL, n);
+    }
+
+    std::size_t slot_of(std::uint64_t hash) const {
+        const auto d = _displacements[bucket_of(hash, _displacements.size())];
+        return (d & direct_slot) ? (d & ~direct_slot) : displaced_slot(hash, d, _ids.size());
+    }
+
+    template <class Range>
+    void build(const Range& values) {
+        // encode the values into the arena
+        std::vector<unsigned char> arena;
+        std::vector<std::uint64_t> offsets{0};
+        for (const auto& value : values) {
+            const auto bytes = traits::bytes(value);
+            const auto data  = reinterpret_cast<const unsigned char*>(bytes.data());
+            arena.insert(arena.end(), data, data + bytes.size());
+            offsets.push_back(arena.size());
+        }
+        const std::size_t n = offsets.size() - 1;
+        if (n > 0 && static_cast<std::uint64_t>(n - 1) > static_cast<std::uint64_t>(std::numeric_limits<id_type>::max()))
+            throw serialization_exception();
+        const std::size_t number_of_buckets = n == 0 ? 0 : (n + bucket_size - 1) / bucket_size;
+
+        // duplicated values keep their last id, as in lookup_table, the slots of the other ids remain unused
+        std::vector<std::size_t> keys;
+        {
+            std::unordered_map<std::string_view, std::size_t> last_ids;
+            last_ids.reserve(n);
+            for (std::size_t id = 0; id < n; ++id)
+                last_ids[std::string_view(reinterpret_cast<const char*>(arena.data()) + offsets[id], offsets[id + 1] - offsets[id])] = id;
+            keys.reserve(last_ids.size());
+            for (const auto& entry : last_ids)
+                keys.push_back(entry.second);
+            std::sort(keys.begin(), keys.end());
+        }
+
+        std::vector<std::uint32_t> displacements;
+        std::vector<id_type>       slots;
+        std::uint64_t              seed = 0;
+        while (!find_displacements(arena, offsets, keys, number_of_buckets, seed, displacements, slots))
+            if (++seed == max_seeds)
+                throw serialization_exception();
+        const auto l = layout_of(n, number_of_buckets, seed, arena.size());
+        attach_owned(l);
+        auto data = reinterpret_cast<unsigned char*>(_storage.data());
+        if constexpr (has_offsets)
+            std::memcpy(data + l.offsets, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+        std::memcpy(data + l.ids, slots.data(), slots.size() * sizeof(id_type));
+        std::memcpy(data + l.displacements, displacements.data(), displacements.size() * sizeof(std::uint32_t));
+        std::memcpy(data + l.arena, arena.data(), arena.size());
+    }
+
+    /** @brief Searches a displacement for each bucket, from the largest to the smallest, and fails if one cannot be found.
+     *
+     * Only the ids in `keys` (which must refer to distinct values) get a slot, out of one slot per id.
+     */
+    static bool find_displacements(const std::vector<unsigned char>& arena,
+                                   const std::vector<std::uint64_t>& offsets,
+                                   const std::vector<std::size_t>&   keys,
+                                   std::size_t                       number_of_buckets,
+                                   std::uint64_t                     seed,
+                                   std::vector<std::uint32_t>&       displacements,
+                                   std::vector<id_type>&             slots) {
+        const std::size_t          n = offsets.size() - 1;
+        std::vector<std::uint64_t> hashes(n);
+        std::vector<std::size_t>   bucket_offsets(number_of_buckets + 1);
+        for (auto i : keys) {
+            hashes[i] = impl::hash_bytes(arena.data() + offsets[i], offsets[i + 1] - offsets[i], seed);
+            ++bucket_offsets[bucket_of(hashes[i], number_of_buckets) + 1];
+        }
+        for (std::size_t b = 1; b <= number_of_buckets; ++b)
+            bucket_offsets[b] += bucket_offsets[b - 1];
+        std::vector<std::size_t> members(keys.size());
+        {
+            auto positions = bucket_offsets;
+            for (auto i : keys)
+                members[positions[bucket_of(hashes[i], number_of_buckets)]++] = i;
+        }
+        std::vector<std::size_t> buckets(number_of_buckets);
+        for (std::size_t b = 0; b < number_of_buckets; ++b)
+            buckets[b] = b;
+        std::stable_sort(buckets.begin(), buckets.end(), [&bucket_offsets](auto a, auto b) {
+            return bucket_offsets[a + 1] - bucket_offsets[a] > bucket_offsets[b + 1] - bucket_offsets[b];
+        });
+
+        displacements.assign(number_of_buckets, 0);
+        slots.assign(n, 0);
+        std::vector<char>          used(n);
+        std::vector<std::uint64_t> candidate;
+        std::size_t                next_free = 0;
+        for (auto b : buckets) {
+            const auto first = bucket_offsets[b];
+            const auto count = bucket_offsets[b + 1] - first;
+            if (count == 0)
+                break;
+            if (count == 1) {
+                while (used[next_free])
+                    ++next_free;
+                used[next_free]  = true;
+                slots[next_free] = static_cast<id_type>(members[first]);
+                displacements[b] = direct_slot | static_cast<std::uint32_t>(next_free);
+                continue;
+            }
+            std::uint32_t d = 0;
+            for (;; ++d) {
+                if (d == max_displacement)
+                    return false;
+                candidate.clear();
+                for (std::size_t k = 0; k < count; ++k) {
+                    auto slot = displaced_slot(hashes[members[first + k]], d, n);
+                    if (used[slot] || std::find(candidate.begin(), candidate.end(), slot) != candidate.end())
+                        break;
+                    candidate.push_back(slot);
+                }
+                if (candidate.size() == count)
+                    break;
+            }
+            displacements[b] = d;
+            for (std::size_t k = 0; k < count; ++k) {
+                used[candidate[k]]  = true;
+                slots[candidate[k]] = static_cast<id_type>(members[first + k]);
+            }
+        }
+        return true;
+    }
+
+    header                         _header{};
+    std::vector<std::uint64_t>     _storage; // empty if borrowed
+    const unsigned char*           _data = nullptr;
+    std::span<const std::uint64_t> _offsets;
+    std::span<const id_type>       _ids;           // by slot
+    std::span<const std::uint32_t> _displacements; // by bucket
+    std::span<const unsigned char> _arena;
+};
+
+/** @brief Serializes a frozen_lookup_table as the size of its storage (8 bytes), followed by the storage.
+ *
+ * The storage contains a header, the offsets of the values in the arena (unless they have a fixed size),
+ * the ids by slot, the displacements by bucket and the arena, all in little endian.
+ *
+ * @tparam borrow if set, and the storage is read from a contiguous raw reader at an 8-byte aligned position on a little-endian host,
+ * the table refers to the storage instead of copying it, and stays valid as long as the storage.
+ */
+template <class IdType, class ValueType, bool borrow>
+struct frozen_lookup_table_format : ast::base<ast::format_list<>> {
+    using native_type          = frozen_lookup_table<IdType, ValueType>;
+    static constexpr auto size = ast::dynamic_size();
+
+    template <class RawWriter, class State>
+    void write(RawWriter& raw_writer, State&, const native_type& t) const {
+        const auto& head = t._header;
+        const auto  l    = native_type::layout_of(head.number_of_values, head.number_of_buckets, head.seed, head.arena_size);
+        auto        size = static_cast<std::uint64_t>(l.size);
+        if constexpr (std::endian::native == std::endian::little) {
+            raw_writer(size);
+            raw_writer(static_cast<const void*>(t._data), l.size);
+        } else {
+            std::vector<std::uint64_t> copy((l.size + 7) / 8);
+            std::memcpy(copy.data(), t._data, l.size);
+            convert_byte_order(reinterpret_cast<unsigned char*>(copy.data()), l);
+            size = generic_format::detail::byteswap(size);
+            raw_writer(size);
+            raw_writer(static_cast<const void*>(copy.data()), l.size);
+        }
+    }
+
+    template <class State>
+    std::size_t measure(State&, const native_type& t) const {
+        const auto& head = t._header;
+        return sizeof(std::uint64_t) + native_type::layout_of(head.number_of_values, head.number_of_buckets, head.seed, head.arena_size).size;
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State&) const {
+        std::uint64_t size;
+        raw_reader(size);
+        if constexpr (std::endian::native == std::endian::big)
+            size = generic_format::detail::byteswap(size);
+        if (size > std::numeric_limits<std::size_t>::max())
+            throw deserialization_exception();
+        ast::skip_bytes(raw_reader, static_cast<std::size_t>(size));
+    }
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State&, native_type& t) const {
+        std::uint64_t size;
+        raw_reader(size);
+        if constexpr (std::endian::native == std::endian::big)
+            size = generic_format::detail::byteswap(size);
+        if (size < sizeof(typename native_type::header) || size > std::numeric_limits<std::size_t>::max() / 2)
+            throw deserialization_exception();
+        t = native_type();
+        if constexpr (borrow && ast::ContiguousRawReader<RawReader> && std::endian::native == std::endian::little) {
+            auto data = static_cast<const unsigned char*>(raw_reader.view(0));
+            if (reinterpret_cast<std::uintptr_t>(data) % alignof(std::uint64_t) == 0) {
+                data = static_cast<const unsigned char*>(raw_reader.view(static_cast<std::size_t>(size)));
+                typename native_type::header head;
+                std::memcpy(&head, data, sizeof(head));
+                const auto l = checked_layout(head, size);
+                t._storage.clear();
+                t.attach(data, l);
+                t.validate();
+                return;
+            }
+        }
+        typename native_type::header head;
+        raw_reader(static_cast<void*>(&head), sizeof(head));
+        if constexpr (std::endian::native == std::endian::big)
+            generic_format::detail::byteswap_array<sizeof(std::uint64_t)>(&head, &head, 4);
+        const auto l = checked_layout(head, size);
+        t.attach_owned(l);
+        auto data = reinterpret_cast<unsigned char*>(t._storage.data());
+        raw_reader(static_cast<void*>(data + sizeof(head)), l.size - sizeof(head));
+        if constexpr (std::endian::native == std::endian::big)
+            convert_byte_order(data, l, false);
+        t.validate();
+    }
+
+private:
+    static typename native_type::layout checked_layout(const typename native_type::header& head, std::uint64_t size) {
+        const auto l = native_type::layout_of(head.number_of_values, head.number_of_buckets, head.seed, head.arena_size);
+        if (l.size != size)
+            throw deserialization_exception();
+        return l;
+    }
+
+    /// Swaps the bytes of all sections between little endian and big endian, except the arena (which is already little endian).
+    static void convert_byte_order(unsigned char* data, const typename native_type::layout& l, bool with_header = true) {
+        const auto n = l.head.number_of_values;
+        if (with_header)
+            generic_format::detail::byteswap_array<sizeof(std::uint64_t)>(data, data, 4);
+        if constexpr (native_type::has_offsets)
+            generic_format::detail::byteswap_array<sizeof(std::uint64_t)>(data + l.offsets, data + l.offsets, n + 1);
+        generic_format::detail::byteswap_array<sizeof(IdType)>(data + l.ids, data + l.ids, n);
+        generic_format::detail::byteswap_array<sizeof(std::uint32_t)>(
+            data + l.displacements, data + l.displacements, l.head.number_of_buckets);
+    }
+};
+
+} // end namespace generic_format::lookup
+
+namespace generic_format::dsl {
+
+/**
+ * @brief Serializer for a generic_format::lookup::frozen_lookup_table.
+ *
+ * The table is read back by copying a single block, without rebuilding the hash function.
+ */
+template <class IdType, class ValueType>
+constexpr lookup::frozen_lookup_table_format<IdType, ValueType, false> frozen_lookup_table_format() {
+    return {};
+}
+
+/**
+ * @brief Same as #frozen_lookup_table_format, but when reading from a target with contiguous storage (e.g. a memory mapped file),
+ * the table refers to the storage instead of copying it (provided that it starts at an 8-byte aligned position).
+ */
+template <class IdType, class ValueType>
+constexpr lookup::frozen_lookup_table_format<IdType, ValueType, true> frozen_lookup_table_view_format() {
+    return {};
+}
+
+} // end namespace generic_format::dsl
@@ -8,9 +8,13 @@
 */
 #pragma once
 
+#include <cstdint>
+#include <limits>
+
+#include "generic_format/ast/ast.hpp"
+#include "generic_format/exceptions.hpp"
 #include "generic_format/lookup/lookup_table.hpp"
-#include "generic_format/mapping/mapping.hpp"
-#include "generic_format/primitives.hpp"
+#include "generic_format/mapping/container.hpp"
 
 namespace generic_format {
 namespace lookup {
@@ -19,6 +23,7 @@ template <ast::Format IdFormat, ast::Format ValueFormat>
 struct _lookup_type {
     using id_format    = IdFormat;
     using value_format = ValueFormat;
+    using table_type   = lookup_table<typename IdFormat::native_type, typename ValueFormat::native_type>;
 };
 
 template <ast::Format IdFormat, ast::Format ValueFormat>
@@ -26,61 +31,99 @@ constexpr _lookup_type<IdFormat, ValueFormat> lookup_type(IdFormat, ValueFormat)
     return {};
 }
 
-namespace detail {
+/** @brief Serializes the ids of a lookup table which have been assigned since the previous delta (see lookup_table_delta).
+ *
+ * A delta is encoded as its first id (via IdFormat), the number of values (as a varint), and the values (via ValueFormat).
+ * Writing reads the table without locking, such that other threads may keep on creating ids.
+ * Reading appends the values to the table, without copying the existing values.
+ */
+template <class IdFormat, class ValueFormat, class Table>
+struct lookup_table_delta_format : ast::base<ast::format_list<IdFormat, ValueFormat>> {
+    using id_format            = IdFormat;
+    using value_format         = ValueFormat;
+    using count_format         = ast::varint<std::uint64_t>;
+    using id_type              = typename id_format::native_type;
+    using native_type          = lookup_table_delta<Table>;
+    static constexpr auto size = ast::dynamic_size();
 
-struct lookup_table_placeholder { };
-static constexpr auto lookup_table_size_var = generic_format::dsl::var(lookup_table_placeholder(), generic_format::primitives::uint32_le);
+    static_assert(std::is_same<id_type, typename Table::id_type>::value, "IdFormat must encode the ids of the table!");
+    static_assert(std::is_same<typename value_format::native_type, typename Table::value_type>::value,
+                  "ValueFormat must encode the values of the table!");
 
-// We need a helper class because partial specialization works only for classes,
-// and we need partial specialization to destructure the LookupType.
-template <class LookupType>
-struct lookup_table_format_helper;
-
-template <class IdType, class ValueType>
-struct initial_id_reference : public generic_format::ast::reference<lookup_table_builder<IdType, ValueType>, IdType> {
-    using builder_type = lookup_table_builder<IdType, ValueType>;
-    auto operator()(const builder_type& table) const {
-        return table.initial_id();
+    template <class RawWriter, class State>
+    void write(RawWriter& raw_writer, State& state, const native_type& t) const {
+        const auto& table = t.table();
+        const auto  first = t._next_id;
+        const auto  last  = table.size();
+        if (first > std::numeric_limits<id_type>::max())
+            throw serialization_exception();
+        id_format().write(raw_writer, state, static_cast<id_type>(first));
+        count_format().write(raw_writer, state, static_cast<std::uint64_t>(last - first));
+        for (auto id = first; id < last; ++id)
+            value_format().write(raw_writer, state, table.lookup_by_id(static_cast<id_type>(id)));
+        t._next_id = last;
     }
-    auto& operator()(builder_type& table, IdType id) const {
-        return table.initial_id(id);
+
+    /// Measures the delta without advancing it. If other threads create ids meanwhile, the next write may be larger.
+    template <class State>
+    std::size_t measure(State& state, const native_type& t) const {
+        const auto& table = t.table();
+        const auto  first = t._next_id;
+        const auto  last  = table.size();
+        if (first > std::numeric_limits<id_type>::max())
+            throw serialization_exception();
+        auto result = ast::measure<id_format>(state, static_cast<id_type>(first))
+                      + ast::measure<count_format>(state, static_cast<std::uint64_t>(last - first));
+        for (auto id = first; id < last; ++id)
+            result += ast::measure<value_format>(state, table.lookup_by_id(static_cast<id_type>(id)));
+        return result;
     }
-};
 
-template <class IdType, class ValueType>
-struct values_reference : public generic_format::ast::reference<lookup_table_builder<IdType, ValueType>, std::vector<ValueType>&> {
-    using builder_type = lookup_table_builder<IdType, ValueType>;
-    const auto& operator()(const builder_type& table) const {
-        return table.values(); // TODO(sw) what are re going to return? A reference?
+    /// Skips a delta without appending its values to the table, thus the following deltas cannot be read into that table anymore.
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        id_type       first;
+        std::uint64_t count;
+        id_format().read(raw_reader, state, first);
+        count_format().read(raw_reader, state, count);
+        for (std::uint64_t i = 0; i < count; ++i)
+            ast::skip<value_format>(raw_reader, state);
     }
-    auto& operator()(builder_type& table) const {
-        return table.values();
+
+    template <class RawReader, class State>
+    void read(RawReader& raw_reader, State& state, native_type& t) const {
+        auto&         table = t.table();
+        id_type       first;
+        std::uint64_t count;
+        id_format().read(raw_reader, state, first);
+        count_format().read(raw_reader, state, count);
+        if (first != t._next_id || (count > 0 && count - 1 > std::uint64_t{std::numeric_limits<id_type>::max()} - first))
+            throw deserialization_exception();
+        typename Table::value_type value;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            value_format().read(raw_reader, state, value);
+            // a value which is already known gets its old id
+            if (table.lookup_by_value(value) != t._next_id)
+                throw deserialization_exception();
+            ++t._next_id;
+        }
     }
 };
 
-template <ast::Format IdFormat, ast::Format ValueFormat>
-struct lookup_table_format_helper<_lookup_type<IdFormat, ValueFormat>> {
-    using id_type      = typename IdFormat::native_type;
-    using value_type   = typename IdFormat::native_type;
-    using builder_type = lookup_table_builder<id_type, value_type>;
-    // TODO(sw) how do we get out of std::tuple??? And how to provide the lookup_table_builder instead?
-    using format
-        = decltype(implicit_sequence<builder_type>() << implicit(lookup_table_size_var) << IdFormat * initial_id_lense<id_type, value_type>())
-        << generic_format::dsl::repeated(lookup_table_size_var,
-                                         ValueFormat() * values_lense<id_type, value_type>(),
-                                         generic_format::mapping::vector_mapping());
-};
+} // end namespace lookup
 
-} // end namespace detail
+namespace dsl {
 
-/** @brief Create a format for a LookupType.
+/**
+ * @brief Serializer for the ids of a lookup table created since the previous delta.
  *
- * @tparam LookupType the lookup type.
+ * @param LookupType the formats of the ids and values, see generic_format::lookup::lookup_type.
  */
 template <class LookupType>
-typename lookup_table_format_helper<LookupType>::format constexpr lookup_table_format(const LookupType) {
+constexpr lookup::lookup_table_delta_format<typename LookupType::id_format, typename LookupType::value_format, typename LookupType::table_type>
+lookup_table_delta_format(LookupType) {
     return {};
 }
 
-} // end namespace lookup
+} // end namespace dsl
 } // end namespace generic_format
@@ -10,17 +10,28 @@
 
 #include <vector>
 #include <unordered_map>
-#include <map>
 #include <algorithm>
 #include <mutex>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <type_traits>
 
 #include "generic_format/exceptions.hpp"
+#include "generic_format/lookup/append_only_vector.hpp"
+#include "generic_format/lookup/frozen_lookup_table.hpp"
+#include "generic_format/parallel.hpp"
 
 namespace generic_format::lookup {
 
-template <class IdType, class ValueType, bool thread_safe = true>
+template <class IdType, class ValueType, bool thread_safe = true, std::size_t shards = 1>
 class lookup_table;
 
+template <class IdFormat, class ValueFormat, class Table>
+struct lookup_table_delta_format;
+
 template <class IdType, class ValueType>
 class lookup_table_builder {
 public:
@@ -40,7 +51,8 @@ private:
     std::size_t             index;
     std::vector<value_type> _values;
 
-    friend class lookup_table<IdType, ValueType>;
+    template <class, class, bool, std::size_t>
+    friend class lookup_table;
 };
 
 template <class IdType, class ValueType>
@@ -66,6 +78,38 @@ private:
     std::vector<value_type> _values;
 };
 
+/** @brief Tracks which ids of a lookup table have already been streamed, such that each delta only carries the new ids.
+ *
+ * When written (see lookup_table_delta_format), the values of the ids from next_id() on are written, and next_id() advances.
+ * When read, the values are appended to the table, which must have received exactly the previous deltas.
+ */
+template <class Table>
+class lookup_table_delta {
+public:
+    using table_type = Table;
+    using id_type    = typename table_type::id_type;
+
+    explicit lookup_table_delta(table_type& table, std::size_t next_id = 0)
+        : _table(&table)
+        , _next_id(next_id) { }
+
+    table_type& table() const {
+        return *_table;
+    }
+
+    /// The first id which has not been streamed yet.
+    std::size_t next_id() const {
+        return _next_id;
+    }
+
+private:
+    template <class, class, class>
+    friend struct lookup_table_delta_format;
+
+    table_type*         _table;
+    mutable std::size_t _next_id; // advanced by writing, which takes a const reference
+};
+
 namespace impl {
 
 struct dummy_mutex { };
@@ -91,10 +135,16 @@ struct sync_type<true> {
 }
 
 /** @brief A lookup table which distributes unique, congituous and increasing indices.
+ *
+ * The values are distributed by hash over a number of shards, each with its own lock, such that
+ * concurrent calls to lookup_by_value() only contend if they hit the same shard, or create new ids.
+ * The shards are also the unit of parallelism when merging builders: the map from values to ids is only
+ * filled in parallel if there are several shards.
  */
-template <class IdType, class ValueType, bool thread_safe>
+template <class IdType, class ValueType, bool thread_safe, std::size_t shards>
 class lookup_table {
 private:
+    static_assert(shards > 0, "A lookup table needs at least one shard!");
     using mutex_type = typename impl::sync_type<thread_safe>::mutex_type;
     using guard_type = typename impl::sync_type<thread_safe>::guard_type;
 
@@ -106,71 +156,237 @@ public:
 
     /** @brief Constructs a lookup table by merging a range of builders.
      *
-     * The builders are supposed to contain mutually exclusive intervals.
+     * The builders are supposed to contain mutually exclusive intervals, which together cover the ids from 0 on
+     * (empty builders are ignored). Otherwise, a deserialization_exception is thrown.
+     * Large tables are merged with one thread per hardware thread.
      */
     template <class InputIterator>
-    lookup_table(InputIterator first_builder, InputIterator last_builder) {
-        std::map<IdType, std::size_t> first2last; // used to see if builders are contiguous
-        for (auto& b = first_builder; b != last_builder; ++b) {
-            if (b->_values.size() == 0)
-                continue;
-            auto sz = b->_initial_id + b->_values.size();
-            if (_values.size() < sz)
-                _values.resize(sz);
-            int id = b->_initial_id;
-            for (auto value : b->_values) {
-                _values[id] = value;
-                _map[value] = id;
-                ++id;
-            }
-            first2last[b->_initial_id] = sz;
-        }
+    lookup_table(InputIterator first_builder, InputIterator last_builder)
+        : lookup_table(first_builder, last_builder, 0) { }
+
+    /** @brief Same as above, but merges with up to `threads` threads (0 meaning one per hardware thread).
+     *
+     * The values are copied concurrently, and the shards are filled concurrently. Thus, a table with a
+     * single shard only copies in parallel, and fills its map on a single thread, which dominates the time of the merge.
+     * Small tables are merged with fewer threads, such that each thread handles at least 2^14 values.
+     */
+    template <class InputIterator>
+    lookup_table(InputIterator first_builder, InputIterator last_builder, unsigned threads) {
+        using builder_type = lookup_table_builder<IdType, ValueType>;
+        threads            = detail::thread_count(threads);
 
         // sanity check that sorted builders start with 0 and are contiguous
-        std::size_t boundary = 0;
-        for (const auto& e : first2last) {
-            if (boundary != e.first)
+        std::vector<const builder_type*> builders;
+        for (auto& b = first_builder; b != last_builder; ++b)
+            if (b->_values.size() != 0)
+                builders.push_back(&*b);
+        std::sort(builders.begin(), builders.end(), [](auto lhs, auto rhs) { return lhs->_initial_id < rhs->_initial_id; });
+        std::vector<std::size_t> ends; // the end of the interval of each builder
+        for (auto b : builders) {
+            if (b->_initial_id != (ends.empty() ? 0 : ends.back()))
                 throw deserialization_exception();
-            boundary = e.second;
+            ends.push_back(b->_initial_id + b->_values.size());
         }
+        const std::size_t count = ends.empty() ? 0 : ends.back();
+        if (count != 0 && count - 1 > std::numeric_limits<id_type>::max())
+            throw deserialization_exception();
+        threads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, count / minimal_values_per_thread)));
+
+        _values.append(count, threads, [&](std::size_t id) -> const value_type& {
+            auto b = std::upper_bound(ends.begin(), ends.end(), id) - ends.begin();
+            return builders[b]->_values[id - builders[b]->_initial_id];
+        });
+
+        // each shard is filled in order of the ids, such that duplicated values keep their last id
+        if constexpr (shards == 1) {
+            _shards[0].map.reserve(count);
+            for (std::size_t id = 0; id < count; ++id)
+                _shards[0].map[_values[id]] = static_cast<id_type>(id);
+        } else {
+            std::vector<std::uint32_t> shard_indices(count);
+            detail::parallel_for(count, threads, [&](std::size_t first, std::size_t last) {
+                for (auto id = first; id < last; ++id)
+                    shard_indices[id] = static_cast<std::uint32_t>(shard_index(_values[id]));
+            });
+            // group the ids by shard (counting sort, which keeps the ids of each shard in order)
+            std::size_t offsets[shards + 1]{};
+            for (std::size_t id = 0; id < count; ++id)
+                ++offsets[shard_indices[id] + 1];
+            for (std::size_t s = 1; s <= shards; ++s)
+                offsets[s] += offsets[s - 1];
+            std::vector<std::size_t> order(count);
+            {
+                std::size_t next[shards];
+                std::copy(offsets, offsets + shards, next);
+                for (std::size_t id = 0; id < count; ++id)
+                    order[next[shard_indices[id]]++] = id;
+            }
+            detail::parallel_for(shards, threads, [&](std::size_t first, std::size_t last) {
+                for (auto s = first; s < last; ++s) {
+                    auto& map = _shards[s].map;
+                    map.reserve(offsets[s + 1] - offsets[s]);
+                    for (auto i = offsets[s]; i < offsets[s + 1]; ++i)
+                        map[_values[order[i]]] = static_cast<id_type>(order[i]);
+                }
+            });
+        }
+    }
+
+    /// The number of ids handed out so far.
+    std::size_t size() const {
+        return _values.size();
     }
 
     /**
      * @brief Maps an id to a value.
+     *
+     * Does not lock, since values are never moved nor modified once they got an id.
+     * The id must have been returned by lookup_by_value() (or been loaded) before.
      */
     const value_type& lookup_by_id(id_type id) const {
-        // slow-path (maybe values.size() is not up to date)
-        guard_type lock(_mutex);
+        assert(id < _values.size());
         return _values[id];
     }
 
     /**
      * @brief Maps a value to an id. If no id exists, creates a new id.
+     *
+     * For frequent values, see lookup_table_cache.
      */
     id_type lookup_by_value(const value_type& value) {
-        // TODO(sw) fast-path: thread-local copy of map?
-        guard_type lock(_mutex);
-        if (_map.count(value)) {
-            return _map[value];
+        auto&      shard = shard_of(value);
+        guard_type lock(shard.mutex);
+        return intern(shard, value);
+    }
+
+    /**
+     * @brief Maps each value to an id, as lookup_by_value() would do, and writes them to `ids` (which must have the same size).
+     *
+     * Each shard is locked once for all values which are already known, new values get their ids in order of appearance.
+     */
+    void lookup_by_values(std::span<const value_type> values, std::span<id_type> ids) {
+        assert(values.size() == ids.size());
+        if constexpr (shards == 1) {
+            guard_type lock(_shards[0].mutex);
+            for (std::size_t i = 0; i < values.size(); ++i)
+                ids[i] = intern(_shards[0], values[i]);
         } else {
-            int id = _values.size();
-            // TODO(sw) handle overflow of id_type!
-            _values.push_back(value);
-            _map[value] = id;
-            return id;
+            // group the values by shard (counting sort of their indices)
+            std::vector<std::size_t> shard_indices(values.size());
+            std::size_t              offsets[shards + 1]{};
+            for (std::size_t i = 0; i < values.size(); ++i)
+                ++offsets[(shard_indices[i] = shard_index(values[i])) + 1];
+            for (std::size_t s = 1; s <= shards; ++s)
+                offsets[s] += offsets[s - 1];
+            std::vector<std::size_t> order(values.size());
+            for (std::size_t i = 0; i < values.size(); ++i)
+                order[offsets[shard_indices[i]]++] = i;
+
+            std::vector<char> found(values.size());
+            std::size_t       begin = 0;
+            for (std::size_t s = 0; s < shards; ++s) {
+                const auto end = offsets[s];
+                if (begin == end)
+                    continue;
+                guard_type lock(_shards[s].mutex);
+                for (; begin < end; ++begin) {
+                    const auto i  = order[begin];
+                    auto       it = _shards[s].map.find(values[i]);
+                    if (it != _shards[s].map.end()) {
+                        ids[i]   = it->second;
+                        found[i] = true;
+                    }
+                }
+            }
+            for (std::size_t i = 0; i < values.size(); ++i)
+                if (!found[i])
+                    ids[i] = lookup_by_value(values[i]);
         }
     }
 
+    /// Maps each id to its value, as lookup_by_id() would do, and writes pointers to them to `values` (which must have the same size).
+    void lookup_by_ids(std::span<const id_type> ids, std::span<const value_type*> values) const {
+        assert(values.size() == ids.size());
+        for (std::size_t i = 0; i < ids.size(); ++i)
+            values[i] = &lookup_by_id(ids[i]);
+    }
+
+    /**
+     * @brief Returns an immutable copy of the table, with a perfect hash function (see frozen_lookup_table).
+     *
+     * Values which get an id concurrently may or may not be contained.
+     */
+    frozen_lookup_table<id_type, value_type> freeze() const {
+        return frozen_lookup_table<id_type, value_type>(snapshot_from_id(0).values());
+    }
+
     // TODO(sw) for internal use (serialization) only
     auto snapshot_from_id(id_type initial_id) const {
-        assert(initial_id <= _values.size());
-        return lookup_table_snapshot<id_type, value_type>(initial_id, std::vector<value_type>(_values.begin() + initial_id, _values.end()));
+        const auto size = _values.size();
+        assert(initial_id <= size);
+        std::vector<value_type> values;
+        values.reserve(size - initial_id);
+        for (std::size_t id = initial_id; id < size; ++id)
+            values.push_back(_values[id]);
+        return lookup_table_snapshot<id_type, value_type>(initial_id, std::move(values));
     }
 
 private:
-    std::vector<value_type>                 _values;
-    std::unordered_map<value_type, id_type> _map;
-    mutable mutex_type                      _mutex;
+    static constexpr std::size_t minimal_values_per_thread = 1 << 14;
+
+    struct alignas(64) shard_type {
+        std::unordered_map<value_type, id_type> map;
+        mutex_type                              mutex;
+    };
+
+    static std::size_t shard_index(const value_type& value) {
+        if constexpr (shards == 1) {
+            return 0;
+        } else {
+            // the high bits of the hash, since the map uses the low bits for its buckets
+            auto hash = static_cast<std::uint64_t>(std::hash<value_type>()(value)) * 0x9e3779b97f4a7c15ULL;
+            return (hash >> 32) % shards;
+        }
+    }
+
+    shard_type& shard_of(const value_type& value) {
+        return _shards[shard_index(value)];
+    }
+
+    /// Maps a value to an id, creating a new id if needed. The shard must be locked.
+    id_type intern(shard_type& shard, const value_type& value) {
+        auto [it, inserted] = shard.map.try_emplace(value, id_type());
+        if (inserted) {
+            try {
+                it->second = append(value);
+            } catch (...) {
+                shard.map.erase(it);
+                throw;
+            }
+        }
+        return it->second;
+    }
+
+    /// Assigns the next id to a new value.
+    id_type append(const value_type& value) {
+        append_guard_type lock(_append_mutex);
+        auto              id = static_cast<id_type>(_values.size());
+        // TODO(sw) handle overflow of id_type!
+        _values.push_back(value);
+        return id;
+    }
+
+    // with a single shard, its lock already serializes the writers
+    using append_mutex_type = std::conditional_t<shards == 1, impl::dummy_mutex, mutex_type>;
+    using append_guard_type = std::conditional_t<shards == 1, impl::dummy_guard, guard_type>;
+
+    impl::append_only_vector<value_type> _values;
+    shard_type                           _shards[shards];
+    append_mutex_type                    _append_mutex;
 };
 
+/// A lookup table for many concurrent writers.
+template <class IdType, class ValueType>
+using concurrent_lookup_table = lookup_table<IdType, ValueType, true, 16>;
+
 } // end namespace generic_format::lookup
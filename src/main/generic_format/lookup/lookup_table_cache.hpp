@@ -0,0 +1,119 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace generic_format::lookup {
+
+/** @brief A read-through cache in front of a lookup_table, to be owned by a single thread.
+ *
+ * Hits of lookup_by_value() are served without touching the shared table. Since ids never change,
+ * cached entries never need to be invalidated.
+ *
+ * The cache is direct-mapped: each value can only be cached in one slot (chosen by its hash), and evicts
+ * the previous value of that slot. Thus the memory is bounded by the capacity.
+ */
+template <class Table>
+class lookup_table_cache {
+public:
+    using table_type = Table;
+    using id_type    = typename table_type::id_type;
+    using value_type = typename table_type::value_type;
+
+    /// The capacity is rounded up to a power of two.
+    explicit lookup_table_cache(table_type& table, std::size_t capacity = 1024)
+        : _table(&table)
+        , _slots(std::bit_ceil(std::max(capacity, std::size_t{1}))) { }
+
+    /// Same as lookup_table::lookup_by_value().
+    id_type lookup_by_value(const value_type& value) {
+        auto& slot = slot_of(value);
+        if (slot && slot->first == value) {
+            ++_hits;
+            return slot->second;
+        }
+        ++_misses;
+        auto id = _table->lookup_by_value(value);
+        slot.emplace(value, id);
+        return id;
+    }
+
+    /// Same as lookup_table::lookup_by_values(), the misses are forwarded to the table in a single batch.
+    void lookup_by_values(std::span<const value_type> values, std::span<id_type> ids) {
+        assert(values.size() == ids.size());
+        _missing_indices.clear();
+        _missing_values.clear();
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            auto& slot = slot_of(values[i]);
+            if (slot && slot->first == values[i]) {
+                ids[i] = slot->second;
+            } else {
+                _missing_indices.push_back(i);
+                _missing_values.push_back(values[i]);
+            }
+        }
+        _hits += values.size() - _missing_indices.size();
+        _misses += _missing_indices.size();
+        if (_missing_indices.empty())
+            return;
+        _missing_ids.resize(_missing_indices.size());
+        _table->lookup_by_values(_missing_values, _missing_ids);
+        for (std::size_t j = 0; j < _missing_indices.size(); ++j) {
+            ids[_missing_indices[j]] = _missing_ids[j];
+            slot_of(_missing_values[j]).emplace(_missing_values[j], _missing_ids[j]);
+        }
+    }
+
+    /// Same as lookup_table::lookup_by_id(), which is not cached, since it does not lock.
+    const value_type& lookup_by_id(id_type id) const {
+        return _table->lookup_by_id(id);
+    }
+
+    std::size_t capacity() const {
+        return _slots.size();
+    }
+
+    /// The number of calls to lookup_by_value() which have been served by the cache.
+    std::size_t hits() const {
+        return _hits;
+    }
+
+    /// The number of calls to lookup_by_value() which have been forwarded to the table.
+    std::size_t misses() const {
+        return _misses;
+    }
+
+private:
+    using slot_type = std::optional<std::pair<value_type, id_type>>;
+
+    slot_type& slot_of(const value_type& value) {
+        return _slots[std::hash<value_type>()(value) & (_slots.size() - 1)];
+    }
+
+    table_type*            _table;
+    std::vector<slot_type> _slots;
+    std::size_t            _hits   = 0;
+    std::size_t            _misses = 0;
+
+    // buffers for lookup_by_values(), kept to avoid allocations
+    std::vector<std::size_t> _missing_indices;
+    std::vector<value_type>  _missing_values;
+    std::vector<id_type>     _missing_ids;
+};
+
+} // end namespace generic_format::lookup
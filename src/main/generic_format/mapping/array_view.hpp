@@ -0,0 +1,201 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <span>
+
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/ast/placeholder_container.hpp"
+#include "generic_format/ast/placeholder_map.hpp"
+#include "generic_format/exceptions.hpp"
+#include "generic_format/targets/unbounded_memory.hpp"
+
+namespace generic_format::mapping {
+
+/** @brief A random-access view of consecutive values of a statically sized format in a contiguous buffer.
+ *
+ * Since all values have the same size, the i-th value starts at `i * stride`, and it is only decoded when it is accessed.
+ * Views have no mutable state, so that several threads can scan (e.g. disjoint subviews of) the same view.
+ *
+ * A view can be obtained from a buffer, or from a reader of a memory or memory-mapped target (see targets::reader::view()).
+ */
+template <ast::StaticallySizedFormat F>
+class array_view {
+public:
+    using format     = F;
+    using value_type = typename F::native_type;
+
+    /// The number of bytes of each value.
+    static constexpr std::size_t stride = F::size.size();
+
+    /// A random-access iterator, which decodes a value on dereferencing (like the iterators of std::vector<bool>, it returns proxies).
+    class iterator {
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = array_view::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = value_type;
+        using pointer           = void;
+
+        iterator() = default;
+
+        explicit iterator(const unsigned char* data)
+            : _data(data) { }
+
+        value_type operator*() const {
+            return decode(_data);
+        }
+
+        value_type operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        iterator& operator++() {
+            _data += stride;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        iterator& operator--() {
+            _data -= stride;
+            return *this;
+        }
+
+        iterator operator--(int) {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        iterator& operator+=(difference_type n) {
+            _data += n * static_cast<difference_type>(stride);
+            return *this;
+        }
+
+        iterator& operator-=(difference_type n) {
+            _data -= n * static_cast<difference_type>(stride);
+            return *this;
+        }
+
+        friend iterator operator+(iterator it, difference_type n) {
+            return it += n;
+        }
+
+        friend iterator operator+(difference_type n, iterator it) {
+            return it += n;
+        }
+
+        friend iterator operator-(iterator it, difference_type n) {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const iterator& lhs, const iterator& rhs) {
+            return (lhs._data - rhs._data) / static_cast<difference_type>(stride);
+        }
+
+        auto operator<=>(const iterator&) const = default;
+
+    private:
+        const unsigned char* _data{nullptr};
+    };
+
+    array_view() = default;
+
+    /// A view of the values in `size` bytes at `data`. A partial value at the end throws a deserialization_exception.
+    array_view(const void* data, std::size_t size)
+        : _data(static_cast<const unsigned char*>(data))
+        , _size(size / stride) {
+        if (size % stride != 0)
+            throw deserialization_exception();
+    }
+
+    array_view(F, const void* data, std::size_t size)
+        : array_view(data, size) { }
+
+    /// Decodes the i-th value, without bounds check.
+    value_type operator[](std::size_t i) const {
+        return decode(_data + i * stride);
+    }
+
+    /// Decodes the i-th value. An index out of range throws a deserialization_exception.
+    value_type at(std::size_t i) const {
+        if (i >= _size)
+            throw deserialization_exception();
+        return (*this)[i];
+    }
+
+    /// Decodes `values.size()` consecutive values, starting with the value at `first`.
+    void read(std::size_t first, std::span<value_type> values) const {
+        check_range(first, values.size());
+        targets::unbounded_memory::unbounded_memory_raw_reader raw_reader{_data + first * stride};
+        state_type                                             state;
+        for (auto& value : values)
+            F().read(raw_reader, state, value);
+    }
+
+    /// A view of `count` values, starting with the value at `first`, e.g. to partition a scan.
+    array_view subview(std::size_t first, std::size_t count) const {
+        check_range(first, count);
+        return {_data + first * stride, count * stride};
+    }
+
+    /// The number of values.
+    std::size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    iterator begin() const {
+        return iterator{_data};
+    }
+
+    iterator end() const {
+        return iterator{_data + _size * stride};
+    }
+
+    const void* data() const {
+        return _data;
+    }
+
+private:
+    using state_type = ast::placeholder_container<ast::placeholder_map<>>;
+
+    static value_type decode(const unsigned char* data) {
+        targets::unbounded_memory::unbounded_memory_raw_reader raw_reader{data};
+        state_type                                             state;
+        value_type                                             value;
+        F().read(raw_reader, state, value);
+        return value;
+    }
+
+    void check_range(std::size_t first, std::size_t count) const {
+        if (first > _size || count > _size - first)
+            throw deserialization_exception();
+    }
+
+    const unsigned char* _data{nullptr};
+    std::size_t          _size{0};
+};
+
+template <class F>
+array_view(F, const void*, std::size_t) -> array_view<F>;
+
+} // end namespace generic_format::mapping
@@ -12,9 +12,16 @@
 #include <vector>
 #include <set>
 
+#include <iterator>
+
 #include <generic_format/accessor/accessor.hpp>
 #include <generic_format/ast/reference.hpp>
 #include <generic_format/ast/inference.hpp>
+#include <generic_format/ast/bytewise.hpp>
+#include <generic_format/ast/capacity.hpp>
+#include <generic_format/ast/measure.hpp>
+#include <generic_format/ast/skip.hpp>
+#include <generic_format/ast/varint.hpp>
 
 namespace generic_format {
 namespace mapping {
@@ -64,13 +71,55 @@ struct container : generic_format::ast::base<generic_format::ast::format_list<In
 
     static constexpr auto size = generic_format::ast::dynamic_size(); // TODO(sw) except if index_format is a constant?
 
+    /// True if the elements are stored contiguously, e.g. in a vector, such that they can be processed as one block.
+    static constexpr bool is_bulk_copyable_type = std::is_same<output_info, vector_output>::value
+                                                  && std::contiguous_iterator<typename native_type::iterator>
+                                                  && std::is_same<native_element_type, native_value_type>::value;
+
+    /// True if the elements can moreover be copied as one block, e.g. for a vector of primitives or of trivially copyable structs.
+    static constexpr bool is_bulk_copyable = [] {
+        if constexpr (is_bulk_copyable_type)
+            return generic_format::ast::is_bytewise_array_element<value_format, native_element_type>();
+        else
+            return false;
+    }();
+
     template <class RawWriter, class State>
     void write(RawWriter& raw_writer, State& state, const native_type& t) const {
         // TODO(sw) verify overflow
         native_index_type sz = static_cast<native_index_type>(t.size());
         index_format().write(raw_writer, state, sz);
-        for (const auto& v : t) {
-            value_format().write(raw_writer, state, v);
+        if constexpr (generic_format::ast::FixedSizeFormat<value_format>) {
+            generic_format::ast::with_capacity(raw_writer, generic_format::ast::block_size(sz, value_format::size.size()), [&](auto& w) {
+                write_values(w, state, t);
+            });
+        } else {
+            write_values(raw_writer, state, t);
+        }
+    }
+
+    template <class State>
+    std::size_t measure(State& state, const native_type& t) const {
+        native_index_type sz     = static_cast<native_index_type>(t.size());
+        auto              result = generic_format::ast::measure<index_format>(state, sz);
+        if constexpr (generic_format::ast::StaticallySizedFormat<value_format>) {
+            return result + generic_format::ast::block_size(sz, value_format::size.size());
+        } else {
+            for (const auto& v : t)
+                result += generic_format::ast::measure<value_format>(state, static_cast<const native_value_type&>(v));
+            return result;
+        }
+    }
+
+    template <class RawReader, class State>
+    void skip(RawReader& raw_reader, State& state) const {
+        native_index_type sz;
+        index_format().read(raw_reader, state, sz);
+        if constexpr (generic_format::ast::StaticallySizedFormat<value_format>) {
+            generic_format::ast::skip_bytes(raw_reader, generic_format::ast::block_size(sz, value_format::size.size()));
+        } else {
+            for (native_index_type i = 0; i < sz; ++i)
+                generic_format::ast::skip<value_format>(raw_reader, state);
         }
     }
 
@@ -79,7 +128,57 @@ struct container : generic_format::ast::base<generic_format::ast::format_list<In
         // TODO(sw) verify overflow
         native_index_type sz;
         index_format().read(raw_reader, state, sz);
+        // for fixed-size values, check the capacity before initializing the container
+        if constexpr (generic_format::ast::FixedSizeFormat<value_format>) {
+            generic_format::ast::with_capacity(raw_reader, generic_format::ast::block_size(sz, value_format::size.size()), [&](auto& r) {
+                read_values(r, state, t, sz);
+            });
+        } else {
+            // each LEB128 value takes at least 1 byte, so a malformed size can be detected before initializing the container
+            if constexpr (generic_format::ast::is_leb128<value_format, typename value_format::native_type>::value
+                          && generic_format::ast::BoundedContiguousRawReader<RawReader>) {
+                if (generic_format::ast::block_size(sz, 1) > raw_reader.remaining())
+                    throw deserialization_exception();
+            }
+            read_values(raw_reader, state, t, sz);
+        }
+    }
+
+private:
+    template <class RawWriter, class State>
+    void write_values(RawWriter& raw_writer, State& state, const native_type& t) const {
+        if constexpr (is_bulk_copyable) {
+            raw_writer(static_cast<const void*>(t.data()), t.size() * sizeof(native_element_type));
+            return;
+        }
+        if constexpr (is_bulk_copyable_type && generic_format::ast::is_byte_swapped<value_format, native_element_type>::value) {
+            value_format::write_array(raw_writer, t.data(), t.size());
+            return;
+        }
+        if constexpr (is_bulk_copyable_type && generic_format::ast::is_leb128<value_format, native_element_type>::value) {
+            value_format::write_array(raw_writer, t.data(), t.size());
+            return;
+        }
+        for (const auto& v : t) {
+            value_format().write(raw_writer, state, v);
+        }
+    }
+
+    template <class RawReader, class State>
+    void read_values(RawReader& raw_reader, State& state, native_type& t, native_index_type sz) const {
         output_info().initialize(t, sz);
+        if constexpr (is_bulk_copyable) {
+            raw_reader(static_cast<void*>(t.data()), t.size() * sizeof(native_element_type));
+            return;
+        }
+        if constexpr (is_bulk_copyable_type && generic_format::ast::is_byte_swapped<value_format, native_element_type>::value) {
+            value_format::read_array(raw_reader, t.data(), t.size());
+            return;
+        }
+        if constexpr (is_bulk_copyable_type && generic_format::ast::is_leb128<value_format, native_element_type>::value) {
+            value_format::read_array(raw_reader, t.data(), t.size());
+            return;
+        }
         auto output = output_info().output_iterator(t);
         for (native_index_type i = 0; i < sz; ++i) {
             native_value_type v;
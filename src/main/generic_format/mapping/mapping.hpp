@@ -12,3 +12,5 @@
 #include "generic_format/mapping/container.hpp"
 #include "generic_format/mapping/vector.hpp"
 #include "generic_format/mapping/struct_adaptor.hpp"
+#include "generic_format/mapping/record_view.hpp"
+#include "generic_format/mapping/array_view.hpp"
@@ -0,0 +1,233 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/ast/placeholder_container.hpp"
+#include "generic_format/ast/placeholder_map.hpp"
+#include "generic_format/ast/sequence.hpp"
+#include "generic_format/ast/skip.hpp"
+#include "generic_format/exceptions.hpp"
+#include "generic_format/targets/bounded_memory.hpp"
+
+namespace generic_format::mapping {
+
+template <class Format>
+class record_view;
+
+/** @brief A view of a record (e.g. an adapted struct or tuple) in a contiguous buffer, which decodes a field only when it is accessed.
+ *
+ * The offsets of the fields up to the first field of dynamic size are known at compile time. The offsets of the following
+ * fields are found by skipping the preceding fields (see ast::skip()) on first access, and are cached.
+ * Like a reader, a view must not be used by several threads at once.
+ *
+ * Formats with variables are not supported, since a field could not be decoded independently of the previous fields.
+ */
+template <class NativeType, ast::Format... Fields>
+class record_view<ast::sequence<NativeType, ast::format_list<Fields...>>> {
+public:
+    using format      = ast::sequence<NativeType, ast::format_list<Fields...>>;
+    using native_type = NativeType;
+
+    static constexpr std::size_t number_of_fields = sizeof...(Fields);
+    static_assert(number_of_fields > 0, "A record needs at least one field!");
+    static_assert(!ast::uses_variables<format>::value, "Record views do not support variables!");
+
+    /// The native type of the I-th field, e.g. the type of the I-th member of an adapted struct.
+    template <std::size_t I>
+    using field_type = typename std::tuple_element_t<I, std::tuple<Fields...>>::small_type;
+
+private:
+    static constexpr std::array<bool, number_of_fields> statically_sized{ast::StaticallySizedFormat<Fields>...};
+    static constexpr std::array<std::size_t, number_of_fields> static_sizes{(ast::StaticallySizedFormat<Fields> ? Fields::size.size() : 0)...};
+
+    /// The offsets of the fields, as far as they are known at compile time.
+    static constexpr std::array<std::size_t, number_of_fields + 1> static_offsets = [] {
+        std::array<std::size_t, number_of_fields + 1> result{};
+        for (std::size_t i = 0; i < number_of_fields; ++i)
+            result[i + 1] = result[i] + static_sizes[i];
+        return result;
+    }();
+
+public:
+    /// The number of offsets which are known at compile time, i.e. of the fields up to and including the first field of dynamic size.
+    static constexpr std::size_t number_of_static_offsets = [] {
+        std::size_t n = 1;
+        while (n <= number_of_fields && statically_sized[n - 1])
+            ++n;
+        return n;
+    }();
+
+    record_view(const void* data, std::size_t size)
+        : _data(static_cast<const unsigned char*>(data))
+        , _size(size)
+        , _offsets(static_offsets)
+        , _known(number_of_static_offsets - 1) { }
+
+    record_view(format, const void* data, std::size_t size)
+        : record_view(data, size) { }
+
+    /// Decodes the I-th field. A field which exceeds the buffer throws a deserialization_exception.
+    template <std::size_t I>
+    field_type<I> get() const {
+        static_assert(I < number_of_fields, "Field index out of range!");
+        using field_format = typename std::tuple_element_t<I, std::tuple<Fields...>>::format;
+        auto          reader = reader_at(offset<I>());
+        state_type    state;
+        field_type<I> value;
+        ast::read_checked<field_format>(reader, state, value);
+        return value;
+    }
+
+    /// Decodes all fields.
+    void read(native_type& t) const {
+        auto       reader = reader_at(0);
+        state_type state;
+        ast::read_checked<format>(reader, state, t);
+    }
+
+    /// The offset of the I-th field from the start of the record, or the size of the record for I = number_of_fields.
+    template <std::size_t I>
+    std::size_t offset() const {
+        static_assert(I <= number_of_fields, "Field index out of range!");
+        if constexpr (I < number_of_static_offsets)
+            return static_offsets[I];
+        else
+            return dynamic_offset(I);
+    }
+
+    /// The number of bytes of the record, e.g. to find the next record.
+    std::size_t size() const {
+        return offset<number_of_fields>();
+    }
+
+    const void* data() const {
+        return _data;
+    }
+
+private:
+    using reader_type = targets::bounded_memory::bounded_memory_raw_reader;
+    using state_type  = ast::placeholder_container<ast::placeholder_map<>>;
+
+    template <class Field>
+    static void skip_field(reader_type& reader) {
+        state_type state;
+        ast::skip<Field>(reader, state);
+    }
+
+    reader_type reader_at(std::size_t offset) const {
+        if (offset > _size)
+            throw deserialization_exception();
+        return {_data + offset, _size - offset};
+    }
+
+    /// Skips the fields from the last known offset on, up to the i-th field.
+    std::size_t dynamic_offset(std::size_t i) const {
+        static constexpr void (*skippers[])(reader_type&) = {&skip_field<Fields>...};
+        for (; _known < i; ++_known) {
+            auto reader = reader_at(_offsets[_known]);
+            skippers[_known](reader);
+            _offsets[_known + 1] = _size - reader.remaining();
+        }
+        return _offsets[i];
+    }
+
+    const unsigned char*                                  _data;
+    std::size_t                                           _size;
+    mutable std::array<std::size_t, number_of_fields + 1> _offsets;
+    mutable std::size_t                                   _known; // the index of the last known offset
+};
+
+template <class Format>
+record_view(Format, const void*, std::size_t) -> record_view<Format>;
+
+/** @brief The consecutive records of a format in a contiguous buffer, which are iterated as record_views.
+ *
+ * Advancing to the next record only skips the dynamic fields of the current record, without decoding them.
+ */
+template <class Format>
+class record_range {
+public:
+    using view_type = record_view<Format>;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = view_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const view_type*;
+        using reference         = const view_type&;
+
+        iterator()
+            : _view(nullptr, 0) { }
+
+        iterator(const unsigned char* data, const unsigned char* end)
+            : _view(data, static_cast<std::size_t>(end - data))
+            , _end(end) { }
+
+        reference operator*() const {
+            return _view;
+        }
+
+        pointer operator->() const {
+            return &_view;
+        }
+
+        iterator& operator++() {
+            auto next = static_cast<const unsigned char*>(_view.data()) + _view.size();
+            _view     = view_type(next, static_cast<std::size_t>(_end - next));
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const iterator& other) const {
+            return _view.data() == other._view.data();
+        }
+
+    private:
+        view_type            _view;
+        const unsigned char* _end{nullptr};
+    };
+
+    record_range(const void* data, std::size_t size)
+        : _begin(static_cast<const unsigned char*>(data))
+        , _end(_begin + size) { }
+
+    record_range(Format, const void* data, std::size_t size)
+        : record_range(data, size) { }
+
+    iterator begin() const {
+        return {_begin, _end};
+    }
+
+    iterator end() const {
+        return {_end, _end};
+    }
+
+private:
+    const unsigned char* _begin;
+    const unsigned char* _end;
+};
+
+template <class Format>
+record_range(Format, const void*, std::size_t) -> record_range<Format>;
+
+} // end namespace generic_format::mapping
@@ -0,0 +1,61 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace generic_format::detail {
+
+/// Resolves a requested number of threads, where 0 means one per hardware thread.
+inline unsigned thread_count(unsigned requested) {
+    return requested != 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/** @brief Splits [0, count) into at most `threads` contiguous ranges, and calls `function(begin, end)` for each range concurrently.
+ *
+ * The calling thread handles the first range. All ranges are finished before returning, and the first exception is rethrown.
+ */
+template <class Function>
+void parallel_for(std::size_t count, unsigned threads, Function&& function) {
+    const std::size_t ranges = std::min<std::size_t>(std::max(1u, threads), count);
+    if (ranges <= 1) {
+        if (count > 0)
+            function(std::size_t{0}, count);
+        return;
+    }
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(ranges - 1);
+    std::exception_ptr error;
+    try {
+        for (std::size_t i = 1; i < ranges; ++i)
+            tasks.push_back(std::async(std::launch::async, [&function, count, ranges, i] {
+                function(count * i / ranges, count * (i + 1) / ranges);
+            }));
+        function(std::size_t{0}, count / ranges);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& task : tasks) {
+        try {
+            task.get();
+        } catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // end namespace generic_format::detail
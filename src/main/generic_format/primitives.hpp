@@ -8,22 +8,46 @@
 */
 #pragma once
 
+#include <bit>
+#include <cstdint>
+
 #include "generic_format/ast/raw.hpp"
+#include "generic_format/ast/varint.hpp"
 
 namespace generic_format::primitives {
 
-#define __GENERIC_FORMAT_PRIMITIVE_TYPE(name, type) \
-    struct name##_t : ast::raw<type> {              \
-        constexpr name##_t() { }                    \
-    };                                              \
+// The *_le and *_be formats use little and big endian byte order respectively, independently of the host.
+#define __GENERIC_FORMAT_PRIMITIVE_TYPE(name, type, order) \
+    struct name##_t : ast::ordered_raw<type, order> {      \
+        constexpr name##_t() { }                           \
+    };                                                     \
+    static constexpr name##_t name;
+__GENERIC_FORMAT_PRIMITIVE_TYPE(int8_le, std::int8_t, std::endian::little)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(int16_le, std::int16_t, std::endian::little)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(int32_le, std::int32_t, std::endian::little)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(int64_le, std::int64_t, std::endian::little)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(uint8_le, std::uint8_t, std::endian::little)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(uint16_le, std::uint16_t, std::endian::little)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(uint32_le, std::uint32_t, std::endian::little)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(uint64_le, std::uint64_t, std::endian::little)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(int8_be, std::int8_t, std::endian::big)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(int16_be, std::int16_t, std::endian::big)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(int32_be, std::int32_t, std::endian::big)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(int64_be, std::int64_t, std::endian::big)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(uint8_be, std::uint8_t, std::endian::big)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(uint16_be, std::uint16_t, std::endian::big)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(uint32_be, std::uint32_t, std::endian::big)
+__GENERIC_FORMAT_PRIMITIVE_TYPE(uint64_be, std::uint64_t, std::endian::big)
+
+// Variable-length formats: LEB128 for unsigned integers, and zigzag-mapped LEB128 for signed integers.
+#define __GENERIC_FORMAT_VARIABLE_LENGTH_TYPE(name, format, type) \
+    struct name##_t : ast::format<type> {                         \
+        constexpr name##_t() { }                                  \
+    };                                                            \
     static constexpr name##_t name;
-__GENERIC_FORMAT_PRIMITIVE_TYPE(int8_le, std::int8_t)
-__GENERIC_FORMAT_PRIMITIVE_TYPE(int16_le, std::int16_t)
-__GENERIC_FORMAT_PRIMITIVE_TYPE(int32_le, std::int32_t)
-__GENERIC_FORMAT_PRIMITIVE_TYPE(int64_le, std::int64_t)
-__GENERIC_FORMAT_PRIMITIVE_TYPE(uint8_le, std::uint8_t)
-__GENERIC_FORMAT_PRIMITIVE_TYPE(uint16_le, std::uint16_t)
-__GENERIC_FORMAT_PRIMITIVE_TYPE(uint32_le, std::uint32_t)
-__GENERIC_FORMAT_PRIMITIVE_TYPE(uint64_le, std::uint64_t)
+__GENERIC_FORMAT_VARIABLE_LENGTH_TYPE(varint_u32, varint, std::uint32_t)
+__GENERIC_FORMAT_VARIABLE_LENGTH_TYPE(varint_u64, varint, std::uint64_t)
+__GENERIC_FORMAT_VARIABLE_LENGTH_TYPE(zigzag_i32, zigzag, std::int32_t)
+__GENERIC_FORMAT_VARIABLE_LENGTH_TYPE(zigzag_i64, zigzag, std::int64_t)
 
 } // end namespace generic_format::primitives
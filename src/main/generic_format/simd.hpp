@@ -0,0 +1,38 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+// On x86, kernels are compiled for several instruction sets via target attributes, and selected at runtime.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GENERIC_FORMAT_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace generic_format::detail {
+
+#ifdef GENERIC_FORMAT_X86_SIMD
+
+enum class simd_level { none, ssse3, avx2 };
+
+/// The most capable instruction set supported by the CPU, among the ones for which kernels exist.
+inline simd_level detected_simd_level() {
+    static const simd_level result = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return simd_level::avx2;
+        if (__builtin_cpu_supports("ssse3"))
+            return simd_level::ssse3;
+        return simd_level::none;
+    }();
+    return result;
+}
+
+#endif
+
+} // end namespace generic_format::detail
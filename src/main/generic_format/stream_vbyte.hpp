@@ -0,0 +1,142 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "generic_format/simd.hpp"
+
+namespace generic_format::detail {
+
+/** @brief Stream VByte: 32-bit integers stored in 1 to 4 little-endian bytes, with their lengths stored separately.
+ *
+ * Each control byte holds the length codes (length - 1) of 4 consecutive values, 2 bits each, starting with the lowest bits.
+ * Unused codes of the last control byte are 0. Since the lengths do not depend on the data, the position of the next
+ * 4 values is known without decoding the current ones, which lets SIMD decoders proceed without a dependency on the data.
+ */
+struct stream_vbyte {
+    /// Number of control bytes for `count` values.
+    static constexpr std::size_t control_size(std::size_t count) {
+        return count / 4 + (count % 4 != 0 ? 1 : 0);
+    }
+
+    /// Length code of a value, i.e. its number of bytes minus 1.
+    static constexpr unsigned code(std::uint32_t value) {
+        return value < (1u << 8) ? 0 : value < (1u << 16) ? 1 : value < (1u << 24) ? 2 : 3;
+    }
+};
+
+/// Number of data bytes of 4 values, by control byte.
+inline constexpr auto stream_vbyte_lengths = [] {
+    std::array<unsigned char, 256> result{};
+    for (unsigned control = 0; control < 256; ++control)
+        for (unsigned i = 0; i < 4; ++i)
+            result[control] += static_cast<unsigned char>(((control >> (2 * i)) & 3) + 1);
+    return result;
+}();
+
+/// Encodes `count` values into `control` (stream_vbyte::control_size(count) bytes) and `data` (at most 4 bytes per value).
+/// Returns the number of data bytes.
+inline std::size_t stream_vbyte_encode(const std::uint32_t* values, std::size_t count, unsigned char* control, unsigned char* data) {
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto value = values[i];
+        const auto code  = stream_vbyte::code(value);
+        if (i % 4 == 0)
+            control[i / 4] = 0;
+        control[i / 4] |= static_cast<unsigned char>(code << (2 * (i % 4)));
+        for (unsigned b = 0; b <= code; ++b)
+            data[size++] = static_cast<unsigned char>(value >> (8 * b));
+    }
+    return size;
+}
+
+/// Number of data bytes of `count` values, given their control bytes.
+inline std::size_t stream_vbyte_data_size(const unsigned char* control, std::size_t count) {
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < count / 4; ++i)
+        size += stream_vbyte_lengths[control[i]];
+    for (std::size_t i = count / 4 * 4; i < count; ++i)
+        size += ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+    return size;
+}
+
+/// Decodes values one by one, and returns the end of their data.
+inline const unsigned char* stream_vbyte_decode_scalar(const unsigned char* control,
+                                                       const unsigned char* data,
+                                                       std::uint32_t*       out,
+                                                       std::size_t          first,
+                                                       std::size_t          last) {
+    for (auto i = first; i < last; ++i) {
+        const auto    code  = static_cast<unsigned>(control[i / 4] >> (2 * (i % 4))) & 3;
+        std::uint32_t value = 0;
+        for (unsigned b = 0; b <= code; ++b)
+            value |= static_cast<std::uint32_t>(*data++) << (8 * b);
+        out[i] = value;
+    }
+    return data;
+}
+
+#ifdef GENERIC_FORMAT_X86_SIMD
+
+/// Shuffles which move the data bytes of 4 values into 32-bit lanes, by control byte.
+inline constexpr auto stream_vbyte_shuffles = [] {
+    std::array<std::array<char, 16>, 256> result{};
+    for (unsigned control = 0; control < 256; ++control) {
+        unsigned position = 0;
+        for (unsigned i = 0; i < 4; ++i) {
+            const auto length = ((control >> (2 * i)) & 3) + 1;
+            for (unsigned b = 0; b < 4; ++b)
+                result[control][4 * i + b] = b < length ? static_cast<char>(position + b) : static_cast<char>(0x80); // 0x80 zeroes the byte
+            position += length;
+        }
+    }
+    return result;
+}();
+
+/// Decodes groups of 4 values while 16 data bytes can be loaded, and returns the index of the first value not decoded.
+__attribute__((target("ssse3"))) inline std::size_t stream_vbyte_decode_ssse3(const unsigned char*& data,
+                                                                            const unsigned char*  data_end,
+                                                                            const unsigned char*  control,
+                                                                            std::uint32_t*        out,
+                                                                            std::size_t           count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count && data_end - data >= 16; i += 4) {
+        const auto c       = control[i / 4];
+        const auto shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stream_vbyte_shuffles[c].data()));
+        const auto bytes   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(bytes, shuffle));
+        data += stream_vbyte_lengths[c];
+    }
+    return i;
+}
+
+#endif
+
+/** @brief Decodes `count` values from their control bytes and their data, which must span exactly [data, data_end).
+ *
+ * The size of the data must have been checked via stream_vbyte_data_size() before.
+ * On x86 with SSSE3, 4 values are decoded at once by a shuffle selected by their control byte.
+ */
+inline void stream_vbyte_decode(const unsigned char* control,
+                                const unsigned char* data,
+                                const unsigned char* data_end,
+                                std::uint32_t*       out,
+                                std::size_t          count) {
+    std::size_t first = 0;
+#ifdef GENERIC_FORMAT_X86_SIMD
+    if (detected_simd_level() != simd_level::none)
+        first = stream_vbyte_decode_ssse3(data, data_end, control, out, count);
+#endif
+    stream_vbyte_decode_scalar(control, data, out, first, count);
+}
+
+} // end namespace generic_format::detail
@@ -0,0 +1,54 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace generic_format::targets {
+
+/** @brief Allocates memory in large chunks, which is released only when the arena is destroyed.
+ *
+ * Allocated memory never moves, so views into it remain valid as long as the arena is alive.
+ * Streaming raw readers use an arena to back deserialized views (e.g. std::string_view).
+ */
+class arena {
+public:
+    static constexpr std::size_t default_chunk_size = 64 * 1024;
+
+    explicit arena(std::size_t chunk_size = default_chunk_size)
+        : m_chunk_size{chunk_size} { }
+
+    /// Allocates `size` bytes (without any alignment guarantees).
+    char* allocate(std::size_t size) {
+        if (size > m_remaining) {
+            // large allocations get their own chunk, such that the current chunk can still be used
+            if (size > m_chunk_size / 2) {
+                m_chunks.emplace_back(new char[size]); // not value-initialized, unlike std::make_unique
+                return m_chunks.back().get();
+            }
+            m_chunks.emplace_back(new char[m_chunk_size]);
+            m_current   = m_chunks.back().get();
+            m_remaining = m_chunk_size;
+        }
+        auto result = m_current;
+        m_current += size;
+        m_remaining -= size;
+        return result;
+    }
+
+private:
+    std::size_t                          m_chunk_size;
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    char*                                m_current{nullptr};
+    std::size_t                          m_remaining{0};
+};
+
+} // end namespace generic_format::targets
@@ -8,10 +8,23 @@
 */
 #pragma once
 
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
 #include "generic_format/ast/placeholder_map.hpp"
 #include "generic_format/ast/placeholder_container.hpp"
 #include "generic_format/ast/base.hpp"
+#include "generic_format/ast/capacity.hpp"
+#include "generic_format/ast/measure.hpp"
+#include "generic_format/ast/skip.hpp"
 #include "generic_format/ast/variable.hpp"
+#include "generic_format/exceptions.hpp"
+
+namespace generic_format::mapping {
+template <ast::StaticallySizedFormat F>
+class array_view;
+} // end namespace generic_format::mapping
 
 namespace generic_format::targets {
 
@@ -58,6 +71,32 @@ struct map_for_format {
     using type          = typename ast::merge_placeholder_maps<_current_map, _children_map>::type;
 };
 
+/// Removes the entries of a placeholder_map whose placeholders are never read by F.
+template <ast::Format F, class Map>
+struct read_entries;
+
+template <ast::Format F>
+struct read_entries<F, ast::placeholder_map<>> {
+    using type = ast::placeholder_map<>;
+};
+
+template <ast::Format F, class Entry, class... Entries>
+struct read_entries<F, ast::placeholder_map<Entry, Entries...>> {
+    using _rest = typename read_entries<F, ast::placeholder_map<Entries...>>::type;
+    using type  = std::conditional_t<ast::reads_placeholder<F, typename Entry::placeholder>::value,
+                                    typename ast::placeholder_map_put<_rest, Entry>::type,
+                                    _rest>;
+};
+
+/** @brief The state for writing or reading F, which keeps only the placeholders that are read after being written.
+ *
+ * Formats without such variables get an empty state, which compiles away.
+ */
+template <ast::Format F>
+struct state_for_format {
+    using type = ast::placeholder_container<typename read_entries<F, typename map_for_format<F>::type>::type>;
+};
+
 } // end namespace detail
 
 /** @brief An operation to write a type according to a specific format.
@@ -75,10 +114,16 @@ struct writer {
         : raw_writer{args...} { }
 
     template <class T, ast::Format F>
-    void operator()(const T& t, F f) {
+    void operator()(const T& t, F) {
         using namespace ast;
-        placeholder_container<typename detail::map_for_format<F>::type> state;
-        f.write(raw_writer, state, t);
+        typename detail::state_for_format<F>::type state;
+        write_checked<F>(raw_writer, state, t);
+    }
+
+    /// Flushes the RawWriter, if it buffers its output.
+    void flush() {
+        if constexpr (requires { raw_writer.flush(); })
+            raw_writer.flush();
     }
 
 private:
@@ -100,16 +145,49 @@ struct reader {
         : raw_reader{args...} { }
 
     template <class T, ast::Format F>
-    void operator()(T& t, F f) {
+    void operator()(T& t, F) {
+        using namespace ast;
+        typename detail::state_for_format<F>::type state;
+        read_checked<F>(raw_reader, state, t);
+    }
+
+    /// Advances past a value of format F without decoding it, e.g. to filter records on their first fields.
+    template <ast::Format F>
+    void skip(F) {
         using namespace ast;
-        placeholder_container<typename detail::map_for_format<F>::type> state;
-        f.read(raw_reader, state, t);
+        typename detail::state_for_format<F>::type state;
+        ast::skip<F>(raw_reader, state);
+    }
+
+    /** @brief Returns a random-access view of the next `count` values of format F, and advances past them.
+     *
+     * The values are decoded on access, directly from the memory of the RawReader (e.g. a memory mapping), which has to outlive the view.
+     * Requires generic_format/mapping/array_view.hpp.
+     */
+    template <ast::StaticallySizedFormat F>
+    requires requires(RawReader& r) { r.view(std::size_t{}); }
+    mapping::array_view<F> view(std::size_t count, F) {
+        if (count > std::numeric_limits<std::size_t>::max() / F::size.size())
+            throw deserialization_exception();
+        const auto size = count * F::size.size();
+        return {raw_reader.view(size), size};
     }
 
 private:
     RawReader raw_reader;
 };
 
+/** @brief Returns the exact number of bytes which a writer takes to write `t` according to F, without writing anything.
+ *
+ * E.g. to allocate a buffer once, before writing into it via bounded_memory.
+ * Fixed-size parts of the format are not walked.
+ */
+template <class T, ast::Format F>
+std::size_t measure(const T& t, F) {
+    typename detail::state_for_format<F>::type state;
+    return ast::measure<F>(state, t);
+}
+
 /**
  * @brief Base class for a type-agnostic writer.
  *
@@ -0,0 +1,122 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include "generic_format/exceptions.hpp"
+#include "generic_format/targets/base.hpp"
+#include "generic_format/targets/unbounded_memory.hpp"
+
+namespace generic_format::targets::bounded_memory {
+
+struct bounded_memory_raw_writer : base_raw_writer {
+
+    bounded_memory_raw_writer(void* data, std::size_t size)
+        : m_data{reinterpret_cast<unsigned char*>(data)}
+        , m_end{m_data + size} { }
+
+    void operator()(const void* p, std::size_t size) {
+        check(size);
+        std::memcpy(m_data, p, size);
+        m_data += size;
+    }
+
+    template <class T>
+    void operator()(const T& v) {
+        check(sizeof(T));
+        std::memcpy(m_data, &v, sizeof(T));
+        m_data += sizeof(T);
+    }
+
+    /// Checks once that `size` bytes can be written, and lets `function` write them without further checks.
+    template <class Function>
+    void checked_block(std::size_t size, Function&& function) {
+        check(size);
+        unbounded_memory::unbounded_memory_raw_writer unchecked{m_data};
+        function(unchecked);
+        m_data += size;
+    }
+
+    /// Number of bytes which can still be written.
+    std::size_t remaining() const {
+        return static_cast<std::size_t>(m_end - m_data);
+    }
+
+private:
+    void check(std::size_t size) const {
+        if (size > remaining())
+            throw serialization_exception();
+    }
+
+    unsigned char*       m_data;
+    unsigned char* const m_end;
+};
+
+struct bounded_memory_raw_reader : base_raw_reader {
+
+    bounded_memory_raw_reader(const void* data, std::size_t size)
+        : m_data{reinterpret_cast<const unsigned char*>(data)}
+        , m_end{m_data + size} { }
+
+    void operator()(void* p, std::size_t size) {
+        check(size);
+        std::memcpy(p, m_data, size);
+        m_data += size;
+    }
+
+    template <class T>
+    void operator()(T& v) {
+        check(sizeof(T));
+        std::memcpy(&v, m_data, sizeof(T));
+        m_data += sizeof(T);
+    }
+
+    /// Checks that `size` bytes can be read, returns a pointer to them, and skips them.
+    const void* view(std::size_t size) {
+        check(size);
+        auto result = m_data;
+        m_data += size;
+        return result;
+    }
+
+    /// Checks once that `size` bytes can be read, and lets `function` read them without further checks.
+    template <class Function>
+    void checked_block(std::size_t size, Function&& function) {
+        check(size);
+        unbounded_memory::unbounded_memory_raw_reader unchecked{m_data};
+        function(unchecked);
+        m_data += size;
+    }
+
+    /// Number of bytes which can still be read.
+    std::size_t remaining() const {
+        return static_cast<std::size_t>(m_end - m_data);
+    }
+
+private:
+    void check(std::size_t size) const {
+        if (size > remaining())
+            throw deserialization_exception();
+    }
+
+    const unsigned char*       m_data;
+    const unsigned char* const m_end;
+};
+
+/**
+ * @brief A target which reads from and writes to a memory region identified by a void-pointer and a size.
+ *
+ * Reading or writing beyond the end of the region throws a deserialization_exception or serialization_exception respectively.
+ * Formats of fixed size are checked only once, and so are length-prefixed blocks of fixed-size elements.
+ */
+struct bounded_memory_target : base_target<bounded_memory_raw_writer, bounded_memory_raw_reader> { };
+
+} // end namespace generic_format::targets::bounded_memory
@@ -0,0 +1,305 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include <unistd.h>
+
+#include "generic_format/exceptions.hpp"
+#include "generic_format/targets/arena.hpp"
+#include "generic_format/targets/base.hpp"
+#include "generic_format/targets/unbounded_memory.hpp"
+
+namespace generic_format::targets {
+
+namespace detail {
+
+/// A buffer whose start and size are aligned to the page size.
+class page_aligned_buffer {
+public:
+    explicit page_aligned_buffer(std::size_t size)
+        : m_size{round_to_page_size(size)}
+        , m_data{static_cast<unsigned char*>(std::aligned_alloc(page_size(), m_size))} {
+        if (!m_data)
+            throw std::bad_alloc();
+    }
+
+    unsigned char* data() const {
+        return m_data.get();
+    }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+private:
+    struct free_deleter {
+        void operator()(unsigned char* p) const {
+            std::free(p);
+        }
+    };
+
+    static std::size_t page_size() {
+        static const auto result = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return result;
+    }
+
+    static std::size_t round_to_page_size(std::size_t size) {
+        auto ps = page_size();
+        return size == 0 ? ps : (size + ps - 1) / ps * ps;
+    }
+
+    std::size_t                                  m_size;
+    std::unique_ptr<unsigned char, free_deleter> m_data;
+};
+
+} // end namespace detail
+} // end namespace generic_format::targets
+
+namespace generic_format::targets::file_descriptor {
+
+static constexpr std::size_t default_buffer_size = 64 * 1024;
+
+/** @brief Writes to a file descriptor, coalescing small writes in a buffer.
+ *
+ * The buffer is flushed when it is full, on flush(), and on destruction (ignoring errors).
+ * The file descriptor is not owned.
+ */
+struct file_descriptor_raw_writer : base_raw_writer {
+
+    explicit file_descriptor_raw_writer(int fd, std::size_t buffer_size = default_buffer_size)
+        : m_fd{fd}
+        , m_buffer{buffer_size} { }
+
+    file_descriptor_raw_writer(file_descriptor_raw_writer&& other) noexcept
+        : m_fd{other.m_fd}
+        , m_buffer{std::move(other.m_buffer)}
+        , m_used{std::exchange(other.m_used, 0)} { }
+
+    ~file_descriptor_raw_writer() {
+        try {
+            flush();
+        } catch (const serialization_exception&) {
+            // destructors must not throw, call flush() explicitly to handle errors
+        }
+    }
+
+    void operator()(const void* p, std::size_t size) {
+        if (size <= available()) {
+            append(p, size);
+            return;
+        }
+        flush();
+        if (size < m_buffer.size())
+            append(p, size);
+        else
+            write_fully(p, size); // bypass the buffer for large blocks
+    }
+
+    template <class T>
+    void operator()(const T& v) {
+        if (sizeof(T) > available())
+            flush();
+        append(&v, sizeof(T));
+    }
+
+    /// Makes sure that `size` bytes fit into the buffer, and lets `function` write them directly into the buffer.
+    template <class Function>
+    void checked_block(std::size_t size, Function&& function) {
+        if (size > available()) {
+            flush();
+            if (size > m_buffer.size()) {
+                function(*this);
+                return;
+            }
+        }
+        unbounded_memory::unbounded_memory_raw_writer unchecked{m_buffer.data() + m_used};
+        function(unchecked);
+        m_used += size;
+    }
+
+    /// Writes the buffered data to the file descriptor.
+    void flush() {
+        if (m_used == 0)
+            return;
+        auto used = m_used;
+        m_used    = 0;
+        write_fully(m_buffer.data(), used);
+    }
+
+private:
+    std::size_t available() const {
+        return m_buffer.size() - m_used;
+    }
+
+    void append(const void* p, std::size_t size) {
+        std::memcpy(m_buffer.data() + m_used, p, size);
+        m_used += size;
+    }
+
+    void write_fully(const void* p, std::size_t size) const {
+        auto data = static_cast<const unsigned char*>(p);
+        while (size > 0) {
+            auto written = ::write(m_fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw serialization_exception();
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+    int                         m_fd;
+    detail::page_aligned_buffer m_buffer;
+    std::size_t                 m_used{0};
+};
+
+/** @brief Reads from a file descriptor, serving small reads from a buffer which is refilled in large chunks.
+ *
+ * The file descriptor is not owned. Since data is read ahead, the file offset of the descriptor is undefined afterwards.
+ */
+struct file_descriptor_raw_reader : base_raw_reader {
+
+    explicit file_descriptor_raw_reader(int fd, std::size_t buffer_size = default_buffer_size)
+        : m_fd{fd}
+        , m_buffer{buffer_size} { }
+
+    void operator()(void* p, std::size_t size) {
+        if (size <= buffered()) {
+            consume(p, size);
+            return;
+        }
+        // drain the buffer, then either read large blocks directly or refill
+        auto data = static_cast<unsigned char*>(p);
+        auto n    = buffered();
+        consume(data, n);
+        data += n;
+        size -= n;
+        if (size >= m_buffer.size()) {
+            read_fully(data, size);
+            return;
+        }
+        fill(size);
+        consume(data, size);
+    }
+
+    template <class T>
+    void operator()(T& v) {
+        if (sizeof(T) > buffered())
+            fill(sizeof(T));
+        consume(&v, sizeof(T));
+    }
+
+    /** @brief Drops `size` bytes, seeking over large ranges which are not buffered yet if the file descriptor supports it.
+     *
+     * Seeking past the end of a file is only detected by the next read.
+     */
+    void skip(std::size_t size) {
+        if (size <= buffered()) {
+            m_begin += size;
+            return;
+        }
+        size -= buffered();
+        m_begin = m_end = 0;
+        if (size >= m_buffer.size() && size <= static_cast<std::size_t>(std::numeric_limits<off_t>::max())
+            && ::lseek(m_fd, static_cast<off_t>(size), SEEK_CUR) != -1)
+            return;
+        while (size > m_buffer.size()) {
+            fill(m_buffer.size());
+            m_begin = m_end = 0;
+            size -= m_buffer.size();
+        }
+        fill(size);
+        m_begin += size;
+    }
+
+    /// Makes sure that `size` bytes are buffered, and lets `function` read them directly from the buffer.
+    template <class Function>
+    void checked_block(std::size_t size, Function&& function) {
+        if (size > buffered()) {
+            if (size > m_buffer.size()) {
+                function(*this);
+                return;
+            }
+            fill(size);
+        }
+        unbounded_memory::unbounded_memory_raw_reader unchecked{m_buffer.data() + m_begin};
+        function(unchecked);
+        m_begin += size;
+    }
+
+    /// Backs deserialized views, which therefore live as long as this reader.
+    targets::arena& arena() {
+        return m_arena;
+    }
+
+private:
+    std::size_t buffered() const {
+        return m_end - m_begin;
+    }
+
+    void consume(void* p, std::size_t size) {
+        std::memcpy(p, m_buffer.data() + m_begin, size);
+        m_begin += size;
+    }
+
+    /// Moves the remaining data to the front of the buffer, and reads until at least `size` bytes are buffered.
+    void fill(std::size_t size) {
+        auto n = buffered();
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, n);
+        m_begin = 0;
+        m_end   = n;
+        while (m_end < size) {
+            auto r = ::read(m_fd, m_buffer.data() + m_end, m_buffer.size() - m_end);
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r <= 0)
+                throw deserialization_exception();
+            m_end += static_cast<std::size_t>(r);
+        }
+    }
+
+    void read_fully(void* p, std::size_t size) const {
+        auto data = static_cast<unsigned char*>(p);
+        while (size > 0) {
+            auto r = ::read(m_fd, data, size);
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r <= 0)
+                throw deserialization_exception();
+            data += r;
+            size -= static_cast<std::size_t>(r);
+        }
+    }
+
+    int                         m_fd;
+    detail::page_aligned_buffer m_buffer;
+    std::size_t                 m_begin{0};
+    std::size_t                 m_end{0};
+    targets::arena              m_arena;
+};
+
+/**
+ * @brief A target which reads from and writes to a POSIX file descriptor through an internal page-aligned buffer.
+ *
+ * Formats of fixed size which fit into the buffer are copied directly from or into the buffer.
+ */
+struct file_descriptor_target : base_target<file_descriptor_raw_writer, file_descriptor_raw_reader> { };
+
+} // end namespace generic_format::targets::file_descriptor
@@ -8,6 +8,7 @@
 */
 #pragma once
 
+#include "generic_format/targets/arena.hpp"
 #include "generic_format/targets/base.hpp"
 
 #include <iostream>
@@ -46,8 +47,18 @@ struct iostream_raw_reader : base_raw_reader {
         _is->read(reinterpret_cast<char*>(p), size);
     }
 
+    void skip(std::size_t size) {
+        _is->ignore(static_cast<std::streamsize>(size));
+    }
+
+    /// Backs deserialized views, which therefore live as long as this reader.
+    targets::arena& arena() {
+        return _arena;
+    }
+
 private:
     std::istream* const _is;
+    targets::arena      _arena;
 };
 
 /**
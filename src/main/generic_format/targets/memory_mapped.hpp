@@ -0,0 +1,296 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "generic_format/exceptions.hpp"
+#include "generic_format/targets/base.hpp"
+#include "generic_format/targets/unbounded_memory.hpp"
+
+namespace generic_format::targets {
+
+namespace detail {
+
+inline std::size_t system_page_size() {
+    static const auto result = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return result;
+}
+
+inline std::size_t round_up(std::size_t size, std::size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+/// An owned memory mapping of a file, which is unmapped on destruction.
+class file_mapping {
+public:
+    file_mapping() = default;
+
+    file_mapping(int fd, std::size_t size, int protection) {
+        if (size == 0)
+            return;
+        auto p = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED)
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        m_data = static_cast<unsigned char*>(p);
+        m_size = size;
+    }
+
+    file_mapping(file_mapping&& other) noexcept
+        : m_data{std::exchange(other.m_data, nullptr)}
+        , m_size{std::exchange(other.m_size, 0)} { }
+
+    file_mapping& operator=(file_mapping&& other) noexcept {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        return *this;
+    }
+
+    ~file_mapping() {
+        if (m_data != nullptr)
+            ::munmap(m_data, m_size);
+    }
+
+    unsigned char* data() const {
+        return m_data;
+    }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+private:
+    unsigned char* m_data{nullptr};
+    std::size_t    m_size{0};
+};
+
+/// An owned file descriptor, which is closed on destruction.
+class file_handle {
+public:
+    file_handle(const char* file_name, int flags) {
+        do {
+            m_fd = ::open(file_name, flags, 0644);
+        } while (m_fd < 0 && errno == EINTR);
+        if (m_fd < 0)
+            throw std::system_error(errno, std::generic_category(), file_name);
+    }
+
+    file_handle(file_handle&& other) noexcept
+        : m_fd{std::exchange(other.m_fd, -1)} { }
+
+    ~file_handle() {
+        if (m_fd >= 0)
+            ::close(m_fd);
+    }
+
+    int fd() const {
+        return m_fd;
+    }
+
+private:
+    int m_fd{-1};
+};
+
+} // end namespace detail
+} // end namespace generic_format::targets
+
+namespace generic_format::targets::memory_mapped {
+
+/// @brief Options which tell the kernel how a memory mapped file will be read.
+struct mmap_reader_options {
+    /// Advise MADV_SEQUENTIAL for the whole mapping.
+    bool sequential = true;
+    /// If non-zero, advise MADV_WILLNEED for this many bytes ahead of the cursor, whenever the cursor enters a new window.
+    std::size_t willneed_window = 0;
+};
+
+/** @brief Reads directly from a read-only memory mapping of a file.
+ *
+ * Reading beyond the end of the file throws a deserialization_exception.
+ */
+struct mmap_raw_reader : base_raw_reader {
+
+    explicit mmap_raw_reader(const char* file_name, mmap_reader_options options = {})
+        : m_options{options} {
+        detail::file_handle file{file_name, O_RDONLY};
+        struct stat         st {};
+        if (::fstat(file.fd(), &st) != 0)
+            throw std::system_error(errno, std::generic_category(), file_name);
+        m_mapping = detail::file_mapping{file.fd(), static_cast<std::size_t>(st.st_size), PROT_READ};
+        m_data    = m_mapping.data();
+        m_end     = m_data + m_mapping.size();
+        m_limit   = m_data;
+        if (m_options.sequential && m_mapping.size() > 0)
+            ::madvise(m_mapping.data(), m_mapping.size(), MADV_SEQUENTIAL);
+        advance_window();
+    }
+
+    void operator()(void* p, std::size_t size) {
+        check(size);
+        std::memcpy(p, m_data, size);
+        m_data += size;
+    }
+
+    template <class T>
+    void operator()(T& v) {
+        check(sizeof(T));
+        std::memcpy(&v, m_data, sizeof(T));
+        m_data += sizeof(T);
+    }
+
+    /// Checks that `size` bytes can be read, returns a pointer to them, and skips them.
+    const void* view(std::size_t size) {
+        check(size);
+        auto result = m_data;
+        m_data += size;
+        return result;
+    }
+
+    /// Checks once that `size` bytes can be read, and lets `function` read them directly from the mapping.
+    template <class Function>
+    void checked_block(std::size_t size, Function&& function) {
+        check(size);
+        unbounded_memory::unbounded_memory_raw_reader unchecked{m_data};
+        function(unchecked);
+        m_data += size;
+    }
+
+    /// Number of bytes which can still be read.
+    std::size_t remaining() const {
+        return static_cast<std::size_t>(m_end - m_data);
+    }
+
+private:
+    // m_limit is the end of the current advice window (or the end of the mapping), and never before m_data,
+    // such that a single comparison covers both the bounds check and the advancement of the window.
+    void check(std::size_t size) {
+        if (size > static_cast<std::size_t>(m_limit - m_data)) {
+            if (size > remaining())
+                throw deserialization_exception();
+            advance_window();
+            // keep the invariant m_data <= m_limit, even if a block extends beyond the window
+            m_limit = std::max(m_limit, m_data + size);
+        }
+    }
+
+    void advance_window() {
+        auto window = m_options.willneed_window;
+        if (window == 0) {
+            m_limit = m_end;
+            return;
+        }
+        auto page_size = detail::system_page_size();
+        auto offset    = static_cast<std::size_t>(m_data - m_mapping.data()) / page_size * page_size;
+        auto length    = std::min(detail::round_up(window, page_size), m_mapping.size() - offset);
+        if (length > 0)
+            ::madvise(m_mapping.data() + offset, length, MADV_WILLNEED);
+        // advance again when the cursor reaches the second half of the window
+        m_limit = std::min<const unsigned char*>(m_end, m_mapping.data() + offset + std::max(length / 2, page_size));
+    }
+
+    mmap_reader_options  m_options;
+    detail::file_mapping m_mapping;
+    const unsigned char* m_data{nullptr};
+    const unsigned char* m_end{nullptr};
+    const unsigned char* m_limit{nullptr};
+};
+
+static constexpr std::size_t default_chunk_size = 64 * 1024 * 1024;
+
+/** @brief Writes directly into a shared memory mapping of a file.
+ *
+ * The file is created (or truncated), and grown in chunks via ftruncate and remapping.
+ * On destruction, the file is truncated to the number of bytes actually written.
+ */
+struct mmap_raw_writer : base_raw_writer {
+
+    explicit mmap_raw_writer(const char* file_name, std::size_t chunk_size = default_chunk_size)
+        : m_file{file_name, O_RDWR | O_CREAT | O_TRUNC}
+        , m_chunk_size{detail::round_up(std::max<std::size_t>(chunk_size, 1), detail::system_page_size())} { }
+
+    mmap_raw_writer(mmap_raw_writer&& other) noexcept
+        : m_file{std::move(other.m_file)}
+        , m_chunk_size{other.m_chunk_size}
+        , m_mapping{std::move(other.m_mapping)}
+        , m_used{std::exchange(other.m_used, 0)} { }
+
+    ~mmap_raw_writer() {
+        if (m_file.fd() < 0)
+            return;
+        m_mapping = detail::file_mapping{};
+        // errors are ignored, since destructors must not throw
+        [[maybe_unused]] auto result = ::ftruncate(m_file.fd(), static_cast<off_t>(m_used));
+    }
+
+    void operator()(const void* p, std::size_t size) {
+        if (size == 0)
+            return; // there might be no mapping yet, and memcpy must not be called with a null pointer
+        std::memcpy(reserve(size), p, size);
+        m_used += size;
+    }
+
+    template <class T>
+    void operator()(const T& v) {
+        std::memcpy(reserve(sizeof(T)), &v, sizeof(T));
+        m_used += sizeof(T);
+    }
+
+    /// Grows the mapping once if needed, and lets `function` write `size` bytes directly into the mapping.
+    template <class Function>
+    void checked_block(std::size_t size, Function&& function) {
+        unbounded_memory::unbounded_memory_raw_writer unchecked{reserve(size)};
+        function(unchecked);
+        m_used += size;
+    }
+
+    /// Synchronously writes the mapped data back to the file.
+    void flush() {
+        if (m_used > 0 && ::msync(m_mapping.data(), m_used, MS_SYNC) != 0)
+            throw serialization_exception();
+    }
+
+private:
+    unsigned char* reserve(std::size_t size) {
+        if (size > m_mapping.size() - m_used)
+            grow(size);
+        return m_mapping.data() + m_used;
+    }
+
+    void grow(std::size_t size) {
+        auto capacity = detail::round_up(m_used + size, m_chunk_size);
+        m_mapping     = detail::file_mapping{};
+        if (::ftruncate(m_file.fd(), static_cast<off_t>(capacity)) != 0)
+            throw serialization_exception();
+        m_mapping = detail::file_mapping{m_file.fd(), capacity, PROT_READ | PROT_WRITE};
+    }
+
+    detail::file_handle  m_file;
+    std::size_t          m_chunk_size;
+    detail::file_mapping m_mapping;
+    std::size_t          m_used{0};
+};
+
+/**
+ * @brief A target which reads from and writes to memory mapped files, identified by their file names.
+ *
+ * The reader decodes directly from the mapping, and can advise the kernel to prefetch the pages ahead of its cursor.
+ */
+struct mmap_target : base_target<mmap_raw_writer, mmap_raw_reader> { };
+
+} // end namespace generic_format::targets::memory_mapped
@@ -51,6 +51,13 @@ struct unbounded_memory_raw_reader : base_raw_reader {
         m_data += sizeof(T);
     }
 
+    /// Returns a pointer to the next `size` bytes, and skips them.
+    const void* view(std::size_t size) {
+        auto result = m_data;
+        m_data += size;
+        return result;
+    }
+
 private:
     const unsigned char* m_data;
 };
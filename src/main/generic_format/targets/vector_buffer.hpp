@@ -0,0 +1,93 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "generic_format/targets/base.hpp"
+#include "generic_format/targets/bounded_memory.hpp"
+
+namespace generic_format::targets::vector_buffer {
+
+/** @brief Appends to a vector of bytes.
+ *
+ * @tparam Vector a contiguous container of bytes, e.g. std::vector<std::byte> or std::pmr::vector<std::byte>.
+ */
+template <class Vector>
+struct basic_vector_buffer_raw_writer : base_raw_writer {
+    using vector_type = Vector;
+
+    explicit basic_vector_buffer_raw_writer(vector_type* const buffer)
+        : m_buffer{buffer} { }
+
+    void operator()(const void* p, std::size_t size) {
+        append(static_cast<const unsigned char*>(p), size);
+    }
+
+    template <class T>
+    void operator()(const T& v) {
+        append(reinterpret_cast<const unsigned char*>(&v), sizeof(T));
+    }
+
+    /// Grows the capacity once by at least `size` bytes, and lets `function` append them without reallocating.
+    template <class Function>
+    void checked_block(std::size_t size, Function&& function) {
+        reserve(size);
+        function(*this);
+    }
+
+private:
+    using value_type = typename vector_type::value_type;
+
+    // appends without initializing the new bytes first, unlike resize
+    void append(const unsigned char* p, std::size_t size) {
+        reserve(size);
+        auto first = reinterpret_cast<const value_type*>(p);
+        m_buffer->insert(m_buffer->end(), first, first + size);
+    }
+
+    // grows the capacity geometrically, which makes appending amortized O(1)
+    void reserve(std::size_t size) {
+        auto required = m_buffer->size() + size;
+        if (required > m_buffer->capacity())
+            m_buffer->reserve(std::max(required, 2 * m_buffer->capacity()));
+    }
+
+    vector_type* const m_buffer;
+};
+
+/** @brief Reads from the contents of a vector of bytes.
+ *
+ * The vector must not be modified while reading.
+ */
+template <class Vector>
+struct basic_vector_buffer_raw_reader : bounded_memory::bounded_memory_raw_reader {
+    using vector_type = Vector;
+
+    explicit basic_vector_buffer_raw_reader(const vector_type* const buffer)
+        : bounded_memory_raw_reader{buffer->data(), buffer->size()} { }
+};
+
+/**
+ * @brief A target which appends to and reads from a vector of bytes.
+ *
+ * The writer appends to the end of the vector, growing it as needed. Formats of fixed size grow the vector only once.
+ * The reader starts at the beginning of the vector, and behaves like a bounded_memory_target.
+ * @tparam Vector a contiguous container of bytes.
+ */
+template <class Vector>
+struct basic_vector_buffer_target : base_target<basic_vector_buffer_raw_writer<Vector>, basic_vector_buffer_raw_reader<Vector>> { };
+
+using vector_buffer_target     = basic_vector_buffer_target<std::vector<std::byte>>;
+using pmr_vector_buffer_target = basic_vector_buffer_target<std::pmr::vector<std::byte>>;
+
+} // end namespace generic_format::targets::vector_buffer
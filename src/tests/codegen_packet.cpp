@@ -0,0 +1,85 @@
+/**
+    @file
+    @copyright
+        Copyright Sebastien Wagener 2014
+        Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+        http://www.boost.org/LICENSE_1_0.txt)
+
+    Compiled with optimizations, but not linked: the codegen test compares the disassembly of the generic_format functions with their
+    handwritten counterparts, which have to be identical.
+*/
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "generic_format/dsl.hpp"
+#include "generic_format/generic_format.hpp"
+#include "generic_format/mapping/struct_adaptor.hpp"
+#include "generic_format/targets/unbounded_memory.hpp"
+
+using namespace generic_format::primitives;
+using namespace generic_format::dsl;
+using namespace generic_format::targets::unbounded_memory;
+
+struct Packet {
+    std::uint32_t source, target;
+    std::uint16_t port;
+};
+
+static constexpr auto packet_format = adapt_struct(GENERIC_FORMAT_MEMBER(Packet, source, uint32_le),
+                                                   GENERIC_FORMAT_MEMBER(Packet, target, uint32_le),
+                                                   GENERIC_FORMAT_MEMBER(Packet, port, uint16_le));
+
+// a variable which is never read must not leave any state behind, although it prevents copying source and target as one block
+static constexpr placeholder<0> _packet;
+static constexpr auto           counted_packet_format = adapt_struct(GENERIC_FORMAT_MEMBER(Packet, source, var(GENERIC_FORMAT_PLACEHOLDER(_packet, 0), uint32_le)),
+                                                                     GENERIC_FORMAT_MEMBER(Packet, target, uint32_le),
+                                                                     GENERIC_FORMAT_MEMBER(Packet, port, uint16_le));
+
+extern "C" {
+
+void generic_write_packet(void* data, const Packet& packet) {
+    unbounded_memory_target::writer{data}(packet, packet_format);
+}
+
+void generic_write_counted_packet(void* data, const Packet& packet) {
+    unbounded_memory_target::writer{data}(packet, counted_packet_format);
+}
+
+// source and target are adjacent in memory as well as in the format, so that they are copied as one block
+void handwritten_write_packet(void* data, const Packet& packet) {
+    auto p = static_cast<unsigned char*>(data);
+    std::memcpy(p, &packet, offsetof(Packet, port));
+    std::memcpy(p + 8, &packet.port, 2);
+}
+
+void handwritten_write_fields(void* data, const Packet& packet) {
+    auto p = static_cast<unsigned char*>(data);
+    std::memcpy(p, &packet.source, 4);
+    std::memcpy(p + 4, &packet.target, 4);
+    std::memcpy(p + 8, &packet.port, 2);
+}
+
+void generic_read_packet(const void* data, Packet& packet) {
+    unbounded_memory_target::reader{data}(packet, packet_format);
+}
+
+void generic_read_counted_packet(const void* data, Packet& packet) {
+    unbounded_memory_target::reader{data}(packet, counted_packet_format);
+}
+
+void handwritten_read_packet(const void* data, Packet& packet) {
+    auto p = static_cast<const unsigned char*>(data);
+    std::memcpy(&packet, p, offsetof(Packet, port));
+    std::memcpy(&packet.port, p + 8, 2);
+}
+
+void handwritten_read_fields(const void* data, Packet& packet) {
+    auto p = static_cast<const unsigned char*>(data);
+    std::memcpy(&packet.source, p, 4);
+    std::memcpy(&packet.target, p + 4, 4);
+    std::memcpy(&packet.port, p + 8, 2);
+}
+
+} // extern "C"
@@ -0,0 +1,49 @@
+# Copyright Sebastien Wagener 2014
+# Distributed under the Boost Software License, Version 1.0.
+# (See accompanying file LICENSE_1_0.txt or copy at
+# http://www.boost.org/LICENSE_1_0.txt)
+
+# Compares the disassembly of pairs of functions in an object file, e.g. of generic_format code and of equivalent handwritten code.
+# Usage: cmake -DOBJDUMP=<objdump> -DOBJECT=<object file> -DPAIRS=<function>:<expected function>,... -P codegen_tests.cmake
+
+cmake_minimum_required(VERSION 3.17)
+
+execute_process(COMMAND ${OBJDUMP} -d --no-show-raw-insn ${OBJECT} OUTPUT_VARIABLE disassembly RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${OBJDUMP} failed on ${OBJECT}")
+endif()
+
+# The instructions of a function, without addresses and alignment padding.
+function(instructions function_name output)
+    string(REGEX MATCH "<_?${function_name}>:\n([^\n]+\n)*" body "${disassembly}")
+    if(NOT body)
+        message(FATAL_ERROR "function ${function_name} not found in ${OBJECT}")
+    endif()
+    string(REPLACE "\n" ";" lines "${body}")
+    list(REMOVE_AT lines 0)
+    set(result "")
+    foreach(line IN LISTS lines)
+        string(REGEX REPLACE "^ *[0-9a-f]+:[ \t]*" "" line "${line}")
+        string(STRIP "${line}" line)
+        if(line STREQUAL "" OR line MATCHES "^(nop|xchg +%ax,%ax|data16|cs nop|int3)")
+            continue()
+        endif()
+        list(APPEND result "${line}")
+    endforeach()
+    set(${output} "${result}" PARENT_SCOPE)
+endfunction()
+
+string(REPLACE "," ";" pairs "${PAIRS}")
+foreach(pair IN LISTS pairs)
+    string(REPLACE ":" ";" functions "${pair}")
+    list(GET functions 0 actual_function)
+    list(GET functions 1 expected_function)
+    instructions(${actual_function} actual)
+    instructions(${expected_function} expected)
+    if(NOT actual STREQUAL expected)
+        string(REPLACE ";" "\n  " actual "${actual}")
+        string(REPLACE ";" "\n  " expected "${expected}")
+        message(FATAL_ERROR "${actual_function} differs from ${expected_function}:\n  ${actual}\nexpected:\n  ${expected}")
+    endif()
+    message(STATUS "${actual_function} matches ${expected_function}")
+endforeach()
@@ -10,8 +10,11 @@
 
 #include "generic_format/dsl.hpp"
 #include "generic_format/generic_format.hpp"
+#include "generic_format/mapping/mapping.hpp"
 #include "generic_format/primitives.hpp"
+#include "generic_format/targets/base.hpp"
 
+#include <tuple>
 #include <type_traits>
 
 using namespace generic_format::primitives;
@@ -97,6 +100,32 @@ TEST_CASE("is_unmapped_sequence") {
     static_assert(is_unmapped_sequence<unmapped_sequence<generic_list<uint8_le_t, uint32_le_t>>>::value, "positive is_unmapped_sequence");
 }
 
+static constexpr generic_format::dsl::placeholder<0> _state;
+
+TEST_CASE("state_for_format") {
+    using namespace generic_format::dsl;
+    using generic_format::ast::placeholder_map;
+    using generic_format::ast::placeholder_map_entry;
+    using generic_format::targets::detail::state_for_format;
+
+    static constexpr auto rows    = var(GENERIC_FORMAT_PLACEHOLDER(_state, 0), uint16_le);
+    static constexpr auto columns = var(GENERIC_FORMAT_PLACEHOLDER(_state, 1), uint16_le);
+    static constexpr auto unread  = var(GENERIC_FORMAT_PLACEHOLDER(_state, 2), uint8_le);
+
+    // formats without variables, or whose variables are never read, have an empty state
+    static_assert(std::is_same_v<state_for_format<uint32_le_t>::type, generic_format::ast::placeholder_container<placeholder_map<>>>);
+    static_assert(std::is_same_v<state_for_format<std::remove_cv_t<decltype(unread)>>::type, state_for_format<uint32_le_t>::type>);
+
+    // only the placeholders which are evaluated are kept
+    static constexpr auto format
+        = generic_format::mapping::tuple(rows, unread, columns, generic_format::mapping::vector(eval(rows * columns), uint8_le));
+    using state = state_for_format<std::remove_cv_t<decltype(format)>>::type;
+    static_assert(state::contains<decltype(GENERIC_FORMAT_PLACEHOLDER(_state, 0))>());
+    static_assert(state::contains<decltype(GENERIC_FORMAT_PLACEHOLDER(_state, 1))>());
+    static_assert(!state::contains<decltype(GENERIC_FORMAT_PLACEHOLDER(_state, 2))>());
+    static_assert(std::tuple_size_v<state::tuple_type> == 2);
+}
+
 // Flattening of unmapped_sequence via << operator
 // void test_unmapped_flattening() {
 //    using namespace generic_format::variadic;
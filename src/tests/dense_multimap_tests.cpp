@@ -8,12 +8,134 @@
 */
 #include "test_common.hpp"
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
+#include "generic_format/datastructures/csr_multimap.hpp"
 #include "generic_format/datastructures/dense_multimap.hpp"
+#include "generic_format/dsl.hpp"
+#include "generic_format/primitives.hpp"
+#include "generic_format/targets/vector_buffer.hpp"
 
 using namespace std;
 using namespace generic_format::datastructures;
+using namespace generic_format::primitives;
+using namespace generic_format::targets::vector_buffer;
 
-// TODO(sw)
+static dense_multimap<uint32_t, uint32_t> create_inverted_index(uint32_t number_of_documents, uint32_t number_of_terms) {
+    dense_multimap<uint32_t, uint32_t> result;
+    uint64_t                           state = 1;
+    for (uint32_t document = 0; document < number_of_documents; ++document) {
+        for (int i = 0; i < 20; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            // a few frequent terms, and many rare terms
+            auto term = static_cast<uint32_t>((state >> 33) % ((state >> 62) == 0 ? number_of_terms : 16));
+            result.put(term, document);
+        }
+    }
+    result.sort_values();
+    return result;
+}
+
+template <class Format>
+static vector<std::byte> serialize(const dense_multimap<uint32_t, uint32_t>& map, Format format) {
+    vector<std::byte> buffer;
+    auto              writer = vector_buffer_target::writer{&buffer};
+    writer(map, format);
+    REQUIRE(generic_format::targets::measure(map, format) == buffer.size());
+    return buffer;
+}
+
+template <class Format>
+static void check_round_trip(const dense_multimap<uint32_t, uint32_t>& map, const vector<std::byte>& buffer, Format format) {
+    auto                               reader = vector_buffer_target::reader{&buffer};
+    dense_multimap<uint32_t, uint32_t> actual;
+    reader(actual, format);
+    REQUIRE(actual.size() == map.size());
+    for (uint32_t i = 0; i < map.size(); ++i)
+        REQUIRE(actual[i] == map[i]);
+
+    // skipping consumes exactly the whole buffer
+    auto    skipper = vector_buffer_target::reader{&buffer};
+    uint8_t extra;
+    skipper.skip(format);
+    REQUIRE_THROWS_AS(skipper(extra, uint8_le), generic_format::deserialization_exception);
+}
+
+TEST_CASE("dense multimap storage") {
+    auto map = create_inverted_index(10000, 1000);
+
+    static constexpr auto format        = generic_format::dsl::dense_multimap_format(uint32_le, uint32_le);
+    static constexpr auto packed_format = generic_format::dsl::packed_dense_multimap_format(varint_u32);
+
+    auto buffer        = serialize(map, format);
+    auto packed_buffer = serialize(map, packed_format);
+    check_round_trip(map, buffer, format);
+    check_round_trip(map, packed_buffer, packed_format);
+    // frequent terms have dense posting lists
+    REQUIRE(packed_buffer.size() * 3 < buffer.size());
+}
+
+TEST_CASE("csr multimap") {
+    csr_multimap<uint32_t, uint32_t> map;
+    map.put(3, 8);
+    map.put(1, 11);
+    map.put(3, 9);
+    map.put(2, 10);
+    map.put(5, 12);
+    map.put(1, 7);
+    REQUIRE(map.size() == 6);
+    REQUIRE(map.number_of_values() == 6);
+    vector<vector<uint32_t>> expected{{}, {11, 7}, {10}, {8, 9}, {}, {12}};
+    vector<vector<uint32_t>> actual;
+    for (auto row : map)
+        actual.emplace_back(row.begin(), row.end());
+    REQUIRE(actual == expected);
+    map.sort_values();
+    REQUIRE(vector<uint32_t>(map[1].begin(), map[1].end()) == vector<uint32_t>{7, 11});
+}
+
+TEST_CASE("csr multimap builder") {
+    auto                                     expected = create_inverted_index(1000, 100);
+    csr_multimap_builder<uint32_t, uint32_t> builder;
+    for (uint32_t key = 0; key < expected.size(); ++key)
+        for (auto value : expected[key])
+            builder.put(key, value);
+    auto map = builder.build();
+    REQUIRE(map.size() == expected.size());
+    for (uint32_t key = 0; key < expected.size(); ++key)
+        REQUIRE(vector<uint32_t>(map[key].begin(), map[key].end()) == expected[key]);
+}
+
+TEST_CASE("csr multimap storage") {
+    csr_multimap_builder<uint32_t, uint32_t> builder;
+    auto                                     rows = create_inverted_index(10000, 1000);
+    for (uint32_t key = 0; key < rows.size(); ++key)
+        for (auto value : rows[key])
+            builder.put(key, value);
+    auto map = builder.build();
+
+    static constexpr auto format = generic_format::dsl::csr_multimap_format(uint32_le, uint32_le);
+    vector<std::byte>     buffer;
+    vector_buffer_target::writer{&buffer}(map, format);
+    REQUIRE(generic_format::targets::measure(map, format) == buffer.size());
+    REQUIRE(buffer.size() == 2 * sizeof(uint32_t) + (map.size() + 1 + map.number_of_values()) * sizeof(uint32_t));
+
+    csr_multimap<uint32_t, uint32_t> actual;
+    vector_buffer_target::reader{&buffer}(actual, format);
+    auto    skipper = vector_buffer_target::reader{&buffer};
+    uint8_t extra;
+    skipper.skip(format);
+    REQUIRE_THROWS_AS(skipper(extra, uint8_le), generic_format::deserialization_exception);
+    REQUIRE(actual.size() == map.size());
+    for (uint32_t key = 0; key < map.size(); ++key)
+        REQUIRE(vector<uint32_t>(actual[key].begin(), actual[key].end()) == rows[key]);
+
+    // offsets beyond the values, which leave the map unchanged
+    buffer[sizeof(uint32_t) * (map.size() + 1)] = std::byte{0xff};
+    REQUIRE_THROWS_AS(vector_buffer_target::reader{&buffer}(actual, format), generic_format::deserialization_exception);
+    REQUIRE(actual.size() == map.size());
+    REQUIRE(actual.number_of_values() == map.number_of_values());
+    REQUIRE(vector<uint32_t>(actual[actual.size() - 1].begin(), actual[actual.size() - 1].end()) == rows[map.size() - 1]);
+}
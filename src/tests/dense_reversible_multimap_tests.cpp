@@ -10,12 +10,18 @@
 
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "generic_format/datastructures/dense_reversible_multimap.hpp"
+#include "generic_format/dsl.hpp"
+#include "generic_format/primitives.hpp"
+#include "generic_format/targets/vector_buffer.hpp"
 
 using namespace std;
 using namespace generic_format::datastructures;
+using namespace generic_format::primitives;
+using namespace generic_format::targets::vector_buffer;
 
 static void check_vectors(const std::vector<uint32_t>& actual, const std::vector<uint32_t>& expected) {
     // TODO(sw) reenable
@@ -48,6 +54,110 @@ TEST_CASE("ReversibleMultimap") {
     check_vectors(reverse[10], {2});
     check_vectors(reverse[11], {1});
     check_vectors(reverse[12], {4, 5});
+}
+
+static dense_reversible_multimap<uint32_t> create_graph(uint32_t number_of_nodes) {
+    dense_reversible_multimap<uint32_t> result;
+    uint64_t                            state = 1;
+    for (uint32_t node = 0; node < number_of_nodes; ++node) {
+        for (int i = 0; i < 10; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            result.put(node, static_cast<uint32_t>((state >> 33) % (2 * number_of_nodes)));
+        }
+    }
+    result.sortValues();
+    return result;
+}
+
+static void check_equal(const dense_reversible_multimap<uint32_t>& actual,
+                        const dense_reversible_multimap<uint32_t>& reverse,
+                        const dense_reversible_multimap<uint32_t>& expected) {
+    REQUIRE(actual.size() == expected.size());
+    for (uint32_t i = 0; i < expected.size(); ++i)
+        REQUIRE(actual[i] == expected[i]);
+    auto expected_reverse = expected.reverse();
+    REQUIRE(reverse.size() == expected_reverse.size());
+    for (uint32_t i = 0; i < expected_reverse.size(); ++i)
+        REQUIRE(reverse[i] == expected_reverse[i]);
+}
+
+template <class Format>
+static void check_storage(const dense_reversible_multimap<uint32_t>& expected, Format format) {
+    vector<std::byte> buffer;
+    vector_buffer_target::writer{&buffer}(expected, format);
+    REQUIRE(generic_format::targets::measure(expected, format) == buffer.size());
+    dense_reversible_multimap<uint32_t> actual;
+    auto                                reverse = actual.reverse();
+    vector_buffer_target::reader{&buffer}(actual, format);
+    check_equal(actual, reverse, expected);
+
+    // skipping consumes exactly the whole buffer
+    auto    skipper = vector_buffer_target::reader{&buffer};
+    uint8_t extra;
+    skipper.skip(format);
+    REQUIRE_THROWS_AS(skipper(extra, uint8_le), generic_format::deserialization_exception);
+}
+
+TEST_CASE("ReversibleMultimap storage") {
+    auto graph = create_graph(100000);
+    check_storage(graph, generic_format::dsl::dense_reversible_multimap_format(uint32_le));
+    check_storage(graph, generic_format::dsl::packed_dense_reversible_multimap_format(varint_u32));
+    check_storage(graph, generic_format::dsl::parallel_dense_reversible_multimap_format<3>(uint32_le));
+    check_storage(graph, generic_format::dsl::parallel_dense_reversible_multimap_format<0>(uint32_le));
+}
+
+TEST_CASE("ReversibleMultimap with reverse storage") {
+    auto graph  = create_graph(100000);
+    auto format = generic_format::dsl::dense_reversible_multimap_with_reverse_format(uint32_le);
+    check_storage(graph, format);
+
+    dense_reversible_multimap<uint32_t> lazy_graph(reverse_index::lazy);
+    for (uint32_t i = 0; i < graph.size(); ++i)
+        for (auto v : graph[i])
+            lazy_graph.put(i, v);
+    REQUIRE(!lazy_graph.has_reverse());
+    vector<std::byte> buffer;
+    vector_buffer_target::writer{&buffer}(lazy_graph, format);
+    REQUIRE(lazy_graph.has_reverse());
+
+    dense_reversible_multimap<uint32_t> actual(reverse_index::lazy);
+    vector_buffer_target::reader{&buffer}(actual, format);
+    REQUIRE(actual.has_reverse());
+    check_equal(actual, actual.reverse(), graph);
+}
+
+TEST_CASE("Lazy ReversibleMultimap") {
+    dense_reversible_multimap<uint32_t> forward(reverse_index::lazy);
+    forward.put(3, 8);
+    forward.put(3, 9);
+    forward.put(2, 10);
+    REQUIRE(!forward.has_reverse());
+    auto reverse = forward.reverse();
+    REQUIRE(forward.has_reverse());
+    REQUIRE(reverse[8] == vector<uint32_t>{3});
+    REQUIRE(reverse[10] == vector<uint32_t>{2});
+    // maintained once built
+    forward.put(1, 10);
+    REQUIRE(reverse[10] == vector<uint32_t>{2, 1});
+}
+
+TEST_CASE("Lazy ReversibleMultimap storage") {
+    auto graph  = create_graph(100000);
+    auto format = generic_format::dsl::dense_reversible_multimap_format(uint32_le);
+    vector<std::byte> buffer;
+    vector_buffer_target::writer{&buffer}(graph, format);
+
+    dense_reversible_multimap<uint32_t> actual(reverse_index::lazy);
+    vector_buffer_target::reader{&buffer}(actual, format);
+    REQUIRE(!actual.has_reverse());
 
-    // TODO(sw) also test storage
+    // concurrent first calls build the reverse rows once
+    vector<dense_reversible_multimap<uint32_t>> reverses(4);
+    vector<std::thread>                         threads;
+    for (auto& reverse : reverses)
+        threads.emplace_back([&actual, &reverse] { reverse = actual.reverse(); });
+    for (auto& thread : threads)
+        thread.join();
+    for (const auto& reverse : reverses)
+        check_equal(actual, reverse, graph);
 }
@@ -9,8 +9,12 @@
 #include "test_common.hpp"
 
 #include <algorithm>
+#include <cstdio>
 #include <cstddef>
 #include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <ranges>
 #include <set>
 #include <sstream>
 #include <tuple>
@@ -19,11 +23,19 @@
 #include "generic_format/dsl.hpp"
 #include "generic_format/generic_format.hpp"
 #include "generic_format/mapping/mapping.hpp"
+#include "generic_format/targets/bounded_memory.hpp"
+#include "generic_format/targets/file_descriptor.hpp"
 #include "generic_format/targets/iostream.hpp"
+#include "generic_format/targets/memory_mapped.hpp"
 #include "generic_format/targets/unbounded_memory.hpp"
+#include "generic_format/targets/vector_buffer.hpp"
 
+using namespace generic_format::targets::bounded_memory;
+using namespace generic_format::targets::file_descriptor;
 using namespace generic_format::targets::iostream;
+using namespace generic_format::targets::memory_mapped;
 using namespace generic_format::targets::unbounded_memory;
+using namespace generic_format::targets::vector_buffer;
 
 template <class T>
 struct mock_target_base {
@@ -56,6 +68,8 @@ public:
     }
 
     [[nodiscard]] reader_type reader() const {
+        m_ss->clear();
+        m_ss->seekg(0);
         return {m_ss};
     }
 
@@ -109,7 +123,172 @@ private:
     void*       m_data{nullptr};
 };
 
-using all_targets = std::tuple<mock_target_iostream, mock_target_unbounded_memory>;
+class mock_target_bounded_memory : mock_target_base<bounded_memory_target> {
+public:
+    mock_target_bounded_memory() = default;
+
+    mock_target_bounded_memory(mock_target_bounded_memory&& other) noexcept
+        : m_data(std::move(other.m_data)) { }
+
+    void initialize(std::size_t expected_size) {
+        // exactly the expected size, such that any overrun throws
+        this->m_data = std::vector<unsigned char>(expected_size);
+    }
+
+    [[nodiscard]] writer_type writer() {
+        return {m_data.data(), m_data.size()};
+    }
+
+    [[nodiscard]] reader_type reader() const {
+        return {m_data.data(), m_data.size()};
+    }
+
+    void final_verify() const { }
+
+private:
+    std::vector<unsigned char> m_data;
+};
+
+template <class Vector>
+class mock_target_vector_buffer : mock_target_base<basic_vector_buffer_target<Vector>> {
+public:
+    using vector_type = Vector;
+    using writer_type = typename mock_target_base<basic_vector_buffer_target<Vector>>::writer_type;
+    using reader_type = typename mock_target_base<basic_vector_buffer_target<Vector>>::reader_type;
+
+    mock_target_vector_buffer() = default;
+
+    mock_target_vector_buffer(mock_target_vector_buffer&& other) noexcept
+        : m_expected_size(other.m_expected_size)
+        , m_buffer(std::move(other.m_buffer)) { }
+
+    void initialize(std::size_t expected_size) {
+        this->m_expected_size = expected_size;
+        this->m_buffer.clear();
+    }
+
+    [[nodiscard]] writer_type writer() {
+        return writer_type{&m_buffer};
+    }
+
+    [[nodiscard]] reader_type reader() const {
+        return reader_type{&m_buffer};
+    }
+
+    void final_verify() const {
+        REQUIRE(m_expected_size == m_buffer.size());
+    }
+
+private:
+    std::size_t m_expected_size{};
+    vector_type m_buffer;
+};
+
+class mock_target_file_descriptor : mock_target_base<file_descriptor_target> {
+public:
+    mock_target_file_descriptor() = default;
+
+    mock_target_file_descriptor(mock_target_file_descriptor&& other) noexcept
+        : m_expected_size(other.m_expected_size)
+        , m_file(std::exchange(other.m_file, nullptr)) { }
+
+    ~mock_target_file_descriptor() {
+        if (m_file != nullptr)
+            std::fclose(m_file);
+    }
+
+    void initialize(std::size_t expected_size) {
+        this->m_expected_size = expected_size;
+        this->m_file          = std::tmpfile();
+        REQUIRE(m_file != nullptr);
+    }
+
+    [[nodiscard]] writer_type writer() const {
+        return writer_type{fileno(m_file)};
+    }
+
+    [[nodiscard]] reader_type reader() const {
+        ::lseek(fileno(m_file), 0, SEEK_SET);
+        return reader_type{fileno(m_file)};
+    }
+
+    void final_verify() const {
+        REQUIRE(static_cast<off_t>(m_expected_size) == ::lseek(fileno(m_file), 0, SEEK_END));
+    }
+
+private:
+    std::size_t m_expected_size{};
+    FILE*       m_file{nullptr};
+};
+
+/// A temporary file which is removed on destruction.
+class temporary_file {
+public:
+    temporary_file() {
+        int fd = ::mkstemp(m_name.data());
+        REQUIRE(fd >= 0);
+        ::close(fd);
+    }
+
+    temporary_file(temporary_file&& other) noexcept
+        : m_name(std::exchange(other.m_name, std::string{})) { }
+
+    ~temporary_file() {
+        if (!m_name.empty())
+            std::remove(m_name.c_str());
+    }
+
+    [[nodiscard]] const char* name() const {
+        return m_name.c_str();
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        struct stat st {};
+        REQUIRE(::stat(m_name.c_str(), &st) == 0);
+        return static_cast<std::size_t>(st.st_size);
+    }
+
+private:
+    std::string m_name{"/tmp/generic_format_tests_XXXXXX"};
+};
+
+class mock_target_memory_mapped : mock_target_base<mmap_target> {
+public:
+    mock_target_memory_mapped() = default;
+
+    mock_target_memory_mapped(mock_target_memory_mapped&& other) noexcept
+        : m_expected_size(other.m_expected_size)
+        , m_file(std::move(other.m_file)) { }
+
+    void initialize(std::size_t expected_size) {
+        this->m_expected_size = expected_size;
+        this->m_file          = std::make_unique<temporary_file>();
+    }
+
+    [[nodiscard]] writer_type writer() const {
+        return writer_type{m_file->name()};
+    }
+
+    [[nodiscard]] reader_type reader() const {
+        return reader_type{m_file->name()};
+    }
+
+    void final_verify() const {
+        REQUIRE(m_expected_size == m_file->size());
+    }
+
+private:
+    std::size_t                     m_expected_size{};
+    std::unique_ptr<temporary_file> m_file;
+};
+
+using all_targets = std::tuple<mock_target_iostream,
+                               mock_target_unbounded_memory,
+                               mock_target_bounded_memory,
+                               mock_target_file_descriptor,
+                               mock_target_memory_mapped,
+                               mock_target_vector_buffer<std::vector<std::byte>>,
+                               mock_target_vector_buffer<std::pmr::vector<std::byte>>>;
 
 template <class F>
 struct _chunk {
@@ -168,6 +347,18 @@ void read_chunks(R& reader, C& c, CS... cs) {
     read_chunks(reader, cs...);
 }
 
+/// Skips all chunks but the last one, which is read.
+template <class R, class C>
+void skip_chunks(R& reader, C& c) {
+    read_chunk(reader, c);
+}
+
+template <class R, class C, class C2, class... CS>
+void skip_chunks(R& reader, C&, C2& c2, CS&... cs) {
+    reader.skip(typename C::format());
+    skip_chunks(reader, c2, cs...);
+}
+
 namespace detail {
 
 // TODO(sw) simplify via helper.hpp (sum function)
@@ -189,8 +380,14 @@ struct sizes_sum<C, CS...> {
 
 } // end namespace detail
 
+template <class... CS>
+std::size_t measure_chunks(const CS&... cs) {
+    return (generic_format::targets::measure(cs.input_value, typename CS::format()) + ... + 0);
+}
+
 template <class TARGET, class C, class... CS>
 void check_round_trip(std::size_t expected_size, TARGET&& target, C c, CS... cs) {
+    REQUIRE(measure_chunks(c, cs...) == expected_size);
     target.initialize(expected_size);
     {
         auto writer = target.writer();
@@ -200,6 +397,10 @@ void check_round_trip(std::size_t expected_size, TARGET&& target, C c, CS... cs)
         auto reader = target.reader();
         read_chunks(reader, c, cs...);
     }
+    {
+        auto reader = target.reader();
+        skip_chunks(reader, c, cs...);
+    }
     target.final_verify();
 }
 
@@ -217,10 +418,153 @@ TEMPLATE_LIST_TEST_CASE("primitives", "[template][list]", all_targets) {
     check_round_trip(TestType(), chunk(uint64_le, 42), chunk(uint32_le, 1), chunk(int8_le, -1));
 }
 
+TEMPLATE_LIST_TEST_CASE("big endian primitives", "[template][list]", all_targets) {
+    check_round_trip(TestType(), chunk(uint64_be, 42), chunk(uint32_be, 1), chunk(int16_be, -2), chunk(int8_be, -1));
+}
+
+TEST_CASE("byte order") {
+    std::vector<unsigned char> buffer(2 * (2 + 4 + 8));
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(std::uint16_t{0x0102}, uint16_le);
+        writer(std::uint32_t{0x01020304}, uint32_le);
+        writer(std::uint64_t{0x0102030405060708}, uint64_le);
+        writer(std::uint16_t{0x0102}, uint16_be);
+        writer(std::uint32_t{0x01020304}, uint32_be);
+        writer(std::uint64_t{0x0102030405060708}, uint64_be);
+    }
+    REQUIRE(buffer
+            == (std::vector<unsigned char>{2, 1, 4, 3, 2, 1, 8, 7, 6, 5, 4, 3, 2, 1, 1, 2, 1, 2, 3, 4, 1, 2, 3, 4, 5, 6, 7, 8}));
+
+    // arrays are swapped in bulk
+    using generic_format::dsl::container_format;
+    static constexpr auto      format = container_format(uint16_be, uint32_be);
+    std::vector<std::uint32_t> values(9, 0x01020304);
+    buffer.assign(2 + 9 * 4, 0);
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(values, generic_format::ast::infer_format<std::remove_cv_t<decltype(format)>, std::vector<std::uint32_t>>::type());
+    }
+    REQUIRE(buffer[1] == 9);
+    for (std::size_t i = 0; i < 9; ++i)
+        REQUIRE(std::vector<unsigned char>(buffer.begin() + 2 + 4 * i, buffer.begin() + 6 + 4 * i) == (std::vector<unsigned char>{1, 2, 3, 4}));
+}
+
+template <class T>
+static void check_byteswap_array() {
+    using generic_format::detail::byteswap;
+    using generic_format::detail::byteswap_array;
+    using generic_format::detail::byteswap_array_scalar;
+
+    // cover the vector loops as well as the scalar tails
+    for (std::size_t count : {0, 1, 7, 15, 16, 17, 63, 64, 65, 1000}) {
+        std::vector<T> values(count);
+        for (std::size_t i = 0; i < count; ++i)
+            values[i] = static_cast<T>(0x0123456789abcdefULL * (i + 1));
+        std::vector<T> expected(count);
+        std::transform(values.begin(), values.end(), expected.begin(), [](T v) { return byteswap(v); });
+
+        std::vector<T> swapped(count);
+        byteswap_array<sizeof(T)>(swapped.data(), values.data(), count);
+        REQUIRE(swapped == expected);
+        byteswap_array_scalar<sizeof(T)>(reinterpret_cast<unsigned char*>(swapped.data()),
+                                         reinterpret_cast<const unsigned char*>(values.data()),
+                                         count);
+        REQUIRE(swapped == expected);
+#ifdef GENERIC_FORMAT_X86_SIMD
+        using generic_format::detail::simd_level;
+        auto level = generic_format::detail::detected_simd_level();
+        if (level == simd_level::ssse3 || level == simd_level::avx2) {
+            generic_format::detail::byteswap_array_ssse3<sizeof(T)>(reinterpret_cast<unsigned char*>(swapped.data()),
+                                                                     reinterpret_cast<const unsigned char*>(values.data()),
+                                                                     count);
+            REQUIRE(swapped == expected);
+        }
+        if (level == simd_level::avx2) {
+            generic_format::detail::byteswap_array_avx2<sizeof(T)>(reinterpret_cast<unsigned char*>(swapped.data()),
+                                                                    reinterpret_cast<const unsigned char*>(values.data()),
+                                                                    count);
+            REQUIRE(swapped == expected);
+        }
+#endif
+        // in-place
+        byteswap_array<sizeof(T)>(values.data(), values.data(), count);
+        REQUIRE(values == expected);
+    }
+}
+
+TEST_CASE("byteswap arrays") {
+    check_byteswap_array<std::uint16_t>();
+    check_byteswap_array<std::uint32_t>();
+    check_byteswap_array<std::uint64_t>();
+}
+
+TEMPLATE_LIST_TEST_CASE("varints", "[template][list]", all_targets) {
+    check_round_trip(1 + 2 + 5 + 1 + 10 + 1 + 1 + 5 + 10,
+                     TestType(),
+                     chunk(varint_u32, 0),
+                     chunk(varint_u32, 300),
+                     chunk(varint_u32, std::numeric_limits<std::uint32_t>::max()),
+                     chunk(varint_u64, 127),
+                     chunk(varint_u64, std::numeric_limits<std::uint64_t>::max()),
+                     chunk(zigzag_i32, -64),
+                     chunk(zigzag_i32, 63),
+                     chunk(zigzag_i32, std::numeric_limits<std::int32_t>::min()),
+                     chunk(zigzag_i64, std::numeric_limits<std::int64_t>::max()));
+}
+
+TEST_CASE("varint encoding") {
+    using generic_format::deserialization_exception;
+
+    std::vector<unsigned char> buffer(2 + 1 + 1);
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(std::uint32_t{300}, varint_u32);
+        writer(std::int32_t{-1}, zigzag_i32);
+        writer(std::int32_t{1}, zigzag_i32);
+    }
+    REQUIRE(buffer == (std::vector<unsigned char>{0xac, 0x02, 0x01, 0x02}));
+
+    // overlong, overflowing and truncated encodings are rejected
+    for (auto bytes : std::vector<std::vector<unsigned char>>{
+             {0x80, 0x80, 0x80, 0x80, 0x80, 0x01}, {0xff, 0xff, 0xff, 0xff, 0x1f}, {0x80, 0x80}}) {
+        auto          reader = bounded_memory_target::reader{bytes.data(), bytes.size()};
+        std::uint32_t value;
+        REQUIRE_THROWS_AS(reader(value, varint_u32), deserialization_exception);
+    }
+    std::vector<unsigned char> bytes{0xff, 0xff, 0xff, 0xff, 0x0f};
+    auto                       reader = bounded_memory_target::reader{bytes.data(), bytes.size()};
+    std::uint32_t              value;
+    reader(value, varint_u32);
+    REQUIRE(value == std::numeric_limits<std::uint32_t>::max());
+}
+
 TEMPLATE_LIST_TEST_CASE("strings", "[template][list]", all_targets) {
     check_round_trip((1 + 5) + (2 + 5), TestType(), chunk(string_format(uint8_le), "hello"), chunk(string_format(uint16_le), "world"));
 }
 
+TEMPLATE_LIST_TEST_CASE("string views", "[template][list]", all_targets) {
+    using namespace std::string_view_literals;
+    check_round_trip((1 + 5) + (2 + 5) + 4,
+                     TestType(),
+                     chunk(string_view_format(uint8_le), "hello"sv),
+                     chunk(string_view_format(uint16_le), "world"sv),
+                     chunk(string_view_format(uint32_le), ""sv));
+}
+
+TEST_CASE("string views point into contiguous storage") {
+    std::vector<unsigned char> buffer(1 + 5);
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(std::string("hello"), string_format(uint8_le));
+    }
+    auto             reader = bounded_memory_target::reader{buffer.data(), buffer.size()};
+    std::string_view s;
+    reader(s, string_view_format(uint8_le));
+    REQUIRE(s == "hello");
+    REQUIRE(static_cast<const void*>(s.data()) == buffer.data() + 1);
+}
+
 TEMPLATE_LIST_TEST_CASE("sequence 2", "[template][list]", all_targets) {
     check_round_trip((1 + 5) + (2 + 5) + (1 + 1),
                      TestType(),
@@ -266,6 +610,260 @@ TEMPLATE_LIST_TEST_CASE("set container", "[template][list]", all_targets) {
     check_round_trip(2 + 5 * 1, TestType(), inferred_chunk(format, v));
 }
 
+TEMPLATE_LIST_TEST_CASE("container of primitives", "[template][list]", all_targets) {
+    using generic_format::dsl::container_format;
+    using std::vector;
+
+    static constexpr auto format = container_format(uint32_le, uint32_le);
+
+    vector<uint32_t> empty;
+    vector<uint32_t> v(1000);
+    for (std::size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<uint32_t>(i * 7919);
+    check_round_trip(4 + (4 + 1000 * 4), TestType(), inferred_chunk(format, empty), inferred_chunk(format, v));
+}
+
+TEMPLATE_LIST_TEST_CASE("container of big endian primitives", "[template][list]", all_targets) {
+    using generic_format::dsl::container_format;
+    using std::vector;
+
+    static constexpr auto format16 = container_format(uint32_be, uint16_be);
+    static constexpr auto format32 = container_format(uint32_be, int32_be);
+    static constexpr auto format64 = container_format(uint32_be, uint64_be);
+
+    vector<uint16_t> v16(1001);
+    vector<int32_t>  v32(1002);
+    vector<uint64_t> v64(1003);
+    for (std::size_t i = 0; i < v16.size(); ++i)
+        v16[i] = static_cast<uint16_t>(i * 7919);
+    for (std::size_t i = 0; i < v32.size(); ++i)
+        v32[i] = -static_cast<int32_t>(i * 7919);
+    for (std::size_t i = 0; i < v64.size(); ++i)
+        v64[i] = static_cast<uint64_t>(i) << 40 | i;
+    check_round_trip((4 + 1001 * 2) + (4 + 1002 * 4) + (4 + 1003 * 8),
+                     TestType(),
+                     inferred_chunk(format16, v16),
+                     inferred_chunk(format32, v32),
+                     inferred_chunk(format64, v64));
+}
+
+template <class T>
+static std::vector<T> mixed_magnitudes(std::size_t count) {
+    // runs of small values, interrupted by values of all encoded lengths
+    std::vector<T> result(count);
+    std::uint64_t  state = 42;
+    for (auto& v : result) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        auto bits = (state >> 60) < 10 ? 7 : (state >> 58) % (sizeof(T) * 8);
+        v         = static_cast<T>((state >> 5) & ((std::uint64_t{1} << bits) - 1));
+        if ((state >> 20) % 3 == 0)
+            v = static_cast<T>(-static_cast<std::int64_t>(v) / 2);
+    }
+    return result;
+}
+
+template <class Format, class T>
+static std::size_t encoded_size(Format, const std::vector<T>& values) {
+    std::vector<std::byte> buffer;
+    {
+        auto writer = vector_buffer_target::writer{&buffer};
+        for (auto v : values)
+            writer(v, Format());
+    }
+    return buffer.size();
+}
+
+template <class T>
+static void check_leb128_decode_batch() {
+    using generic_format::detail::leb128_decode_batch;
+    using generic_format::detail::leb128_encode;
+    using generic_format::detail::leb128_max_size;
+
+    auto                       values = mixed_magnitudes<T>(10000);
+    std::vector<unsigned char> encoded(values.size() * leb128_max_size<T>);
+    std::size_t                size = 0;
+    for (auto v : values)
+        size += leb128_encode(v, encoded.data() + size);
+
+    std::vector<T> decoded(values.size());
+    REQUIRE(leb128_decode_batch(encoded.data(), encoded.data() + size, decoded.data(), decoded.size()) == encoded.data() + size);
+    REQUIRE(decoded == values);
+    // truncated input
+    REQUIRE(leb128_decode_batch(encoded.data(), encoded.data() + size - 1, decoded.data(), decoded.size()) == nullptr);
+    // an overlong encoding in the middle of the input
+    std::vector<unsigned char> overlong(encoded.begin(), encoded.begin() + size);
+    overlong.insert(overlong.begin() + 100, leb128_max_size<T> + 1, 0x80);
+    REQUIRE(leb128_decode_batch(overlong.data(), overlong.data() + overlong.size(), decoded.data(), decoded.size()) == nullptr);
+}
+
+TEST_CASE("varint batch decoding") {
+    check_leb128_decode_batch<std::uint32_t>();
+    check_leb128_decode_batch<std::uint64_t>();
+}
+
+TEMPLATE_LIST_TEST_CASE("container of varints", "[template][list]", all_targets) {
+    using generic_format::dsl::container_format;
+    using std::vector;
+
+    static constexpr auto format32 = container_format(varint_u32, varint_u32);
+    static constexpr auto format64 = container_format(varint_u32, varint_u64);
+    static constexpr auto formati  = container_format(varint_u32, zigzag_i64);
+
+    vector<uint32_t> small(1000, 5);
+    auto             v32 = mixed_magnitudes<uint32_t>(1001);
+    auto             v64 = mixed_magnitudes<uint64_t>(1002);
+    auto             vi  = mixed_magnitudes<int64_t>(1003);
+    check_round_trip((2 + 1000) + (2 + encoded_size(varint_u32, v32)) + (2 + encoded_size(varint_u64, v64)) + (2 + encoded_size(zigzag_i64, vi)),
+                     TestType(),
+                     inferred_chunk(format32, small),
+                     inferred_chunk(format32, v32),
+                     inferred_chunk(format64, v64),
+                     inferred_chunk(formati, vi));
+}
+
+static std::vector<std::uint32_t> sorted_values(std::size_t count, std::uint32_t max_gap) {
+    std::vector<std::uint32_t> result(count);
+    std::uint64_t              state = 7;
+    std::uint32_t              value = 1000;
+    for (auto& v : result) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        value += static_cast<std::uint32_t>((state >> 33) % (max_gap + 1));
+        v = value;
+    }
+    return result;
+}
+
+template <class T>
+static std::size_t encoded_size_of(const T& value, auto format) {
+    std::vector<std::byte> buffer;
+    {
+        auto writer = vector_buffer_target::writer{&buffer};
+        writer(value, format);
+    }
+    return buffer.size();
+}
+
+TEMPLATE_LIST_TEST_CASE("delta bitpacked", "[template][list]", all_targets) {
+    static constexpr auto format = delta_bitpacked_format(uint32_le);
+
+    std::vector<std::vector<std::uint32_t>> rows{{},
+                                                 {42},
+                                                 sorted_values(127, 3),
+                                                 sorted_values(128, 0),
+                                                 sorted_values(129, 1000),
+                                                 sorted_values(1000, 100),
+                                                 {5, 3, 0xffffffff, 0, 7}, // unsorted
+                                                 mixed_magnitudes<std::uint32_t>(300)};
+    std::size_t total_size = 0;
+    for (auto& row : rows)
+        total_size += encoded_size_of(row, format);
+    check_round_trip(total_size,
+                     TestType(),
+                     chunk(format, rows[0]),
+                     chunk(format, rows[1]),
+                     chunk(format, rows[2]),
+                     chunk(format, rows[3]),
+                     chunk(format, rows[4]),
+                     chunk(format, rows[5]),
+                     chunk(format, rows[6]),
+                     chunk(format, rows[7]));
+}
+
+TEST_CASE("delta bitpacked size") {
+    static constexpr auto format = delta_bitpacked_format(uint32_le);
+
+    // blocks of 128 values take 5 bytes plus the packed bits; the first 4 deltas are relative to 0, the others are 0
+    REQUIRE(encoded_size_of(std::vector<std::uint32_t>(256, 1000), format) == 4 + (5 + 128 * 10 / 8) + 5);
+    // deltas to the value 4 positions before: 0, 1, 2, 3, 4, 4, ... in the first block, only 4 in the second block
+    std::vector<std::uint32_t> consecutive(256);
+    std::iota(consecutive.begin(), consecutive.end(), 0);
+    REQUIRE(encoded_size_of(consecutive, format) == 4 + (5 + 128 * 3 / 8) + 5);
+    REQUIRE(encoded_size_of(sorted_values(128 * 100, 15), format) < 128 * 100 * 4 / 4);
+}
+
+TEST_CASE("delta bitpacked rejects malformed lengths") {
+    using generic_format::deserialization_exception;
+    using generic_format::serialization_exception;
+
+    // a bogus length must not be trusted for the allocation
+    std::vector<unsigned char> bytes{0xff, 0xff, 0xff, 0x7f, 0x00, 0x00, 0x00, 0x00};
+    auto                       reader = bounded_memory_target::reader{bytes.data(), bytes.size()};
+    std::vector<std::uint32_t> values;
+    REQUIRE_THROWS_AS(reader(values, delta_bitpacked_format(uint32_le)), deserialization_exception);
+
+    // a truncated block is rejected as well
+    std::vector<unsigned char> buffer(encoded_size_of(sorted_values(200, 7), delta_bitpacked_format(uint32_le)));
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(sorted_values(200, 7), delta_bitpacked_format(uint32_le));
+    }
+    auto truncated = bounded_memory_target::reader{buffer.data(), buffer.size() - 1};
+    REQUIRE_THROWS_AS(truncated(values, delta_bitpacked_format(uint32_le)), deserialization_exception);
+
+    // lengths which do not fit into the length format are not truncated
+    std::vector<unsigned char> output(1024);
+    auto                       writer = bounded_memory_target::writer{output.data(), output.size()};
+    REQUIRE_THROWS_AS(writer(sorted_values(300, 1), delta_bitpacked_format(uint8_le)), serialization_exception);
+    REQUIRE_THROWS_AS(generic_format::targets::measure(sorted_values(300, 1), delta_bitpacked_format(uint8_le)), serialization_exception);
+}
+
+TEMPLATE_LIST_TEST_CASE("stream vbyte", "[template][list]", all_targets) {
+    static constexpr auto format = stream_vbyte_format(uint32_le);
+
+    std::vector<std::vector<std::uint32_t>> rows{{},
+                                                 {42},
+                                                 {0, 0xff, 0x100, 0xffff, 0x10000, 0xffffff, 0x1000000, 0xffffffff},
+                                                 sorted_values(1000, 100),
+                                                 mixed_magnitudes<std::uint32_t>(301)};
+    std::size_t total_size = 0;
+    for (auto& row : rows)
+        total_size += encoded_size_of(row, format);
+    check_round_trip(total_size,
+                     TestType(),
+                     chunk(format, rows[0]),
+                     chunk(format, rows[1]),
+                     chunk(format, rows[2]),
+                     chunk(format, rows[3]),
+                     chunk(format, rows[4]));
+}
+
+TEST_CASE("stream vbyte size") {
+    static constexpr auto format = stream_vbyte_format(uint32_le);
+
+    // 1 control byte per 4 values, and 1 to 4 bytes per value
+    REQUIRE(encoded_size_of(std::vector<std::uint32_t>{}, format) == 4);
+    REQUIRE(encoded_size_of(std::vector<std::uint32_t>{1, 2, 3, 4, 5}, format) == 4 + 2 + 5);
+    REQUIRE(encoded_size_of(std::vector<std::uint32_t>{0xff, 0x100, 0x10000, 0x1000000}, format) == 4 + 1 + 1 + 2 + 3 + 4);
+}
+
+TEST_CASE("stream vbyte rejects malformed lengths") {
+    using generic_format::deserialization_exception;
+    using generic_format::serialization_exception;
+
+    // a bogus length must not be trusted for the allocation
+    std::vector<unsigned char> bytes{0xff, 0xff, 0xff, 0x7f, 0x00, 0x00, 0x00, 0x00};
+    auto                       reader = bounded_memory_target::reader{bytes.data(), bytes.size()};
+    std::vector<std::uint32_t> values;
+    REQUIRE_THROWS_AS(reader(values, stream_vbyte_format(uint32_le)), deserialization_exception);
+
+    // truncated data is rejected as well
+    const auto                 row = mixed_magnitudes<std::uint32_t>(100);
+    std::vector<unsigned char> buffer(encoded_size_of(row, stream_vbyte_format(uint32_le)));
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(row, stream_vbyte_format(uint32_le));
+    }
+    auto truncated = bounded_memory_target::reader{buffer.data(), buffer.size() - 1};
+    REQUIRE_THROWS_AS(truncated(values, stream_vbyte_format(uint32_le)), deserialization_exception);
+
+    // lengths which do not fit into the length format are not truncated
+    std::vector<unsigned char> output(1024);
+    auto                       writer = bounded_memory_target::writer{output.data(), output.size()};
+    REQUIRE_THROWS_AS(writer(std::vector<std::uint32_t>(300, 1), stream_vbyte_format(uint8_le)), serialization_exception);
+    REQUIRE_THROWS_AS(generic_format::targets::measure(std::vector<std::uint32_t>(300, 1), stream_vbyte_format(uint8_le)),
+                      serialization_exception);
+}
+
 struct StructWithVector {
     std::vector<uint8_t> data;
 };
@@ -383,3 +981,487 @@ TEMPLATE_LIST_TEST_CASE("struct_sequence", "[template][list]", all_targets) {
 TEMPLATE_LIST_TEST_CASE("nested struct", "[template][list]", all_targets) {
     check_round_trip((4 + 4) + (4 + 4) + 2 + (4 + 14), TestType(), chunk(User_format, {"foo1", "bar1", {10, "Downing Street"}}));
 }
+
+struct Sample {
+    std::uint32_t m_time;
+    std::uint16_t m_channel, m_value;
+};
+
+static bool operator==(const Sample& s1, const Sample& s2) {
+    return s1.m_time == s2.m_time && s1.m_channel == s2.m_channel && s1.m_value == s2.m_value;
+}
+
+static std::ostream& operator<<(std::ostream& os, const Sample& s) {
+    os << "Sample[time=" << s.m_time << ", channel=" << s.m_channel << ", value=" << s.m_value << "]";
+    return os;
+}
+
+static constexpr auto Sample_format = adapt_struct(GENERIC_FORMAT_MEMBER(Sample, m_time, uint32_le),
+                                                   GENERIC_FORMAT_MEMBER(Sample, m_channel, uint16_le),
+                                                   GENERIC_FORMAT_MEMBER(Sample, m_value, uint16_le));
+
+// same members, but not in memory order
+static constexpr auto Sample_reordered_format = adapt_struct(GENERIC_FORMAT_MEMBER(Sample, m_value, uint16_le),
+                                                             GENERIC_FORMAT_MEMBER(Sample, m_time, uint32_le),
+                                                             GENERIC_FORMAT_MEMBER(Sample, m_channel, uint16_le));
+
+TEST_CASE("bytewise structs") {
+    using generic_format::ast::bytewise;
+    using generic_format::ast::is_bytewise_array_element;
+    using sample_format           = std::remove_cv_t<decltype(Sample_format)>;
+    using sample_reordered_format = std::remove_cv_t<decltype(Sample_reordered_format)>;
+    using packet_format           = std::remove_cv_t<decltype(Packet_format)>;
+    using person_format           = std::remove_cv_t<decltype(Person_format)>;
+
+    static_assert(bytewise<sample_format, Sample>::value);
+    static_assert(is_bytewise_array_element<sample_format, Sample>());
+    static_assert(!bytewise<sample_reordered_format, Sample>::value);
+    // the trailing padding of Packet is not serialized, so packets can be copied one by one, but not as an array
+    static_assert(bytewise<packet_format, Packet>::value);
+    static_assert(!is_bytewise_array_element<packet_format, Packet>());
+    static_assert(!bytewise<person_format, Person>::value);
+}
+
+TEMPLATE_LIST_TEST_CASE("bytewise struct", "[template][list]", all_targets) {
+    check_round_trip(TestType(), chunk(Sample_format, {1, 2, 3}), chunk(Sample_reordered_format, {4, 5, 6}));
+}
+
+TEMPLATE_LIST_TEST_CASE("container of bytewise structs", "[template][list]", all_targets) {
+    using generic_format::dsl::container_format;
+    using std::vector;
+
+    static constexpr auto format           = container_format(uint32_le, Sample_format);
+    static constexpr auto reordered_format = container_format(uint32_le, Sample_reordered_format);
+    static constexpr auto packets_format   = container_format(uint32_le, Packet_format);
+
+    vector<Sample> samples{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+    vector<Packet> packets{{1, 2, 3}, {4, 5, 6}};
+    check_round_trip((4 + 3 * 8) + (4 + 3 * 8) + (4 + 2 * 10),
+                     TestType(),
+                     inferred_chunk(format, samples),
+                     inferred_chunk(reordered_format, samples),
+                     inferred_chunk(packets_format, packets));
+}
+
+TEST_CASE("bytewise struct layout") {
+    // the serialized bytes do not depend on whether the struct is copied as a whole
+    std::vector<unsigned char> buffer(2 * 8);
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(Sample{0x04030201, 0x0605, 0x0807}, Sample_format);
+        writer(Sample{0x04030201, 0x0605, 0x0807}, Sample_reordered_format);
+    }
+    REQUIRE(buffer == (std::vector<unsigned char>{1, 2, 3, 4, 5, 6, 7, 8, 7, 8, 1, 2, 3, 4, 5, 6}));
+}
+
+struct Histogram {
+    std::uint16_t              m_rows, m_columns;
+    std::vector<std::uint32_t> m_bins;
+};
+
+static bool operator==(const Histogram& h1, const Histogram& h2) {
+    return h1.m_rows == h2.m_rows && h1.m_columns == h2.m_columns && h1.m_bins == h2.m_bins;
+}
+
+static std::ostream& operator<<(std::ostream& os, const Histogram& h) {
+    os << "Histogram[rows=" << h.m_rows << ", columns=" << h.m_columns << ", bins=" << h.m_bins.size() << "]";
+    return os;
+}
+
+static constexpr placeholder<0> _histogram;
+static constexpr auto           Histogram_rows_var    = var(GENERIC_FORMAT_PLACEHOLDER(_histogram, 0), uint16_le);
+static constexpr auto           Histogram_columns_var = var(GENERIC_FORMAT_PLACEHOLDER(_histogram, 1), uint16_le);
+static constexpr auto           Histogram_format
+    = adapt_struct(GENERIC_FORMAT_MEMBER(Histogram, m_rows, Histogram_rows_var),
+                   GENERIC_FORMAT_MEMBER(Histogram, m_columns, Histogram_columns_var),
+                   GENERIC_FORMAT_MEMBER(Histogram, m_bins, generic_format::mapping::vector(eval(Histogram_rows_var * Histogram_columns_var), uint32_le)));
+
+struct Signal {
+    std::uint32_t              m_length;
+    std::uint32_t              m_channels;
+    std::vector<std::uint32_t> m_samples;
+};
+
+static bool operator==(const Signal& s1, const Signal& s2) {
+    return s1.m_length == s2.m_length && s1.m_channels == s2.m_channels && s1.m_samples == s2.m_samples;
+}
+
+static std::ostream& operator<<(std::ostream& os, const Signal& s) {
+    os << "Signal[length=" << s.m_length << ", channels=" << s.m_channels << ", samples=" << s.m_samples.size() << "]";
+    return os;
+}
+
+static constexpr placeholder<0> _signal;
+static constexpr auto           Signal_length_var   = var(GENERIC_FORMAT_PLACEHOLDER(_signal, 0), uint32_be);
+static constexpr auto           Signal_channels_var = var(GENERIC_FORMAT_PLACEHOLDER(_signal, 1), uint32_be);
+static constexpr auto           Signal_format
+    = adapt_struct(GENERIC_FORMAT_MEMBER(Signal, m_length, Signal_length_var),
+                   GENERIC_FORMAT_MEMBER(Signal, m_channels, Signal_channels_var),
+                   GENERIC_FORMAT_MEMBER(Signal, m_samples, generic_format::mapping::vector(eval(Signal_length_var * Signal_channels_var), uint32_be)));
+
+TEMPLATE_LIST_TEST_CASE("repeated primitives", "[template][list]", all_targets) {
+    Histogram histogram{3, 5, std::vector<std::uint32_t>(3 * 5)};
+    for (std::size_t i = 0; i < histogram.m_bins.size(); ++i)
+        histogram.m_bins[i] = static_cast<std::uint32_t>(i * i);
+    check_round_trip((2 + 2 + 15 * 4) + (2 + 2), TestType(), chunk(Histogram_format, histogram), chunk(Histogram_format, {0, 7, {}}));
+}
+
+TEMPLATE_LIST_TEST_CASE("repeated big endian primitives", "[template][list]", all_targets) {
+    Signal signal{100, 3, std::vector<std::uint32_t>(100 * 3)};
+    for (std::size_t i = 0; i < signal.m_samples.size(); ++i)
+        signal.m_samples[i] = static_cast<std::uint32_t>(i * 0x01010101);
+    check_round_trip(4 + 4 + 300 * 4, TestType(), chunk(Signal_format, signal));
+}
+
+TEST_CASE("bounded memory overrun") {
+    using generic_format::deserialization_exception;
+    using generic_format::serialization_exception;
+    using generic_format::dsl::container_format;
+    using std::vector;
+
+    std::vector<unsigned char> buffer(9);
+
+    // fixed-size formats are checked as a whole before anything is written
+    {
+        auto   writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        Packet packet{1, 2, 3};
+        REQUIRE_THROWS_AS(writer(packet, Packet_format), serialization_exception);
+    }
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(std::string("hello"), string_format(uint32_le));
+        REQUIRE_THROWS_AS(writer(std::string("!"), string_format(uint8_le)), serialization_exception);
+    }
+    {
+        auto        reader = bounded_memory_target::reader{buffer.data(), buffer.size()};
+        std::string s;
+        reader(s, string_format(uint32_le));
+        REQUIRE(s == "hello");
+        REQUIRE_THROWS_AS(reader(s, string_format(uint8_le)), deserialization_exception);
+    }
+
+    // a malformed length is detected before the container is resized
+    static constexpr auto format = container_format(uint32_le, uint32_le);
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(std::uint32_t{1000000}, uint32_le);
+    }
+    {
+        auto             reader = bounded_memory_target::reader{buffer.data(), buffer.size()};
+        vector<uint32_t> v;
+        REQUIRE_THROWS_AS(reader(v, generic_format::ast::infer_format<std::remove_cv_t<decltype(format)>, vector<uint32_t>>::type()),
+                          deserialization_exception);
+        REQUIRE(v.empty());
+    }
+
+    // the same holds for repeated formats, whose size accessor resizes the vector
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(std::uint32_t{1000000}, uint32_be);
+        writer(std::uint32_t{1000}, uint32_be);
+    }
+    {
+        auto   reader = bounded_memory_target::reader{buffer.data(), buffer.size()};
+        Signal signal{};
+        REQUIRE_THROWS_AS(reader(signal, Signal_format), deserialization_exception);
+        REQUIRE(signal.m_samples.empty());
+    }
+
+    // containers of varints take at least 1 byte per value
+    static constexpr auto varints_format = container_format(uint32_le, varint_u32);
+    {
+        auto             reader = bounded_memory_target::reader{buffer.data(), buffer.size()};
+        vector<uint32_t> v;
+        REQUIRE_THROWS_AS(reader(v, generic_format::ast::infer_format<std::remove_cv_t<decltype(varints_format)>, vector<uint32_t>>::type()),
+                          deserialization_exception);
+        REQUIRE(v.empty());
+    }
+}
+
+TEST_CASE("measure") {
+    using generic_format::serialization_exception;
+    using generic_format::targets::measure;
+
+    // fixed-size formats are not walked, and variables are set for the following formats
+    REQUIRE(measure(Packet{1, 2, 3}, Packet_format) == 10);
+    Histogram histogram{2, 3, std::vector<std::uint32_t>(2 * 3)};
+    REQUIRE(measure(histogram, Histogram_format) == 2 + 2 + 6 * 4);
+
+    // a buffer of the measured size is large enough, and is filled exactly
+    const auto user = User{"first", "last", {42, "street"}};
+    const auto size = measure(user, User_format);
+    REQUIRE(size == (4 + 5) + (4 + 4) + 2 + (4 + 6));
+    std::vector<unsigned char> buffer(size);
+    {
+        auto writer = bounded_memory_target::writer{buffer.data(), buffer.size()};
+        writer(user, User_format);
+        REQUIRE_THROWS_AS(writer(std::uint8_t{0}, uint8_le), serialization_exception);
+    }
+    {
+        auto reader = bounded_memory_target::reader{buffer.data(), buffer.size()};
+        User actual;
+        reader(actual, User_format);
+        REQUIRE(actual == user);
+    }
+
+    // values which cannot be written cannot be measured either
+    REQUIRE_THROWS_AS(measure(std::string(256, 'x'), string_format(uint8_le)), serialization_exception);
+}
+
+TEST_CASE("skip") {
+    using generic_format::dsl::container_format;
+
+    // records are filtered on their first field, the others are skipped
+    static constexpr auto ids_format
+        = generic_format::ast::infer_format<std::remove_cv_t<decltype(container_format(uint32_le, varint_u32))>, std::vector<std::uint32_t>>::type();
+    std::vector<std::byte> buffer;
+    {
+        auto writer = vector_buffer_target::writer{&buffer};
+        for (std::uint8_t i = 0; i < 10; ++i) {
+            writer(i, uint8_le);
+            writer(User{"first", std::string(i, 'x'), {i, "street"}}, User_format);
+            writer(std::vector<std::uint32_t>(i, 1u << i), ids_format);
+            writer(Packet{i, i, i}, Packet_format);
+        }
+    }
+    {
+        auto reader = vector_buffer_target::reader{&buffer};
+        for (std::uint8_t i = 0; i < 10; ++i) {
+            std::uint8_t key;
+            reader(key, uint8_le);
+            REQUIRE(key == i);
+            if (key % 3 != 0) {
+                reader.skip(User_format);
+                reader.skip(ids_format);
+                reader.skip(Packet_format);
+                continue;
+            }
+            User user;
+            reader(user, User_format);
+            REQUIRE(user.m_last_name.size() == i);
+            reader.skip(ids_format);
+            Packet packet;
+            reader(packet, Packet_format);
+            REQUIRE(packet.m_port == i);
+        }
+    }
+
+    // variables are still read, since the following formats depend on them
+    Histogram histogram{2, 3, std::vector<std::uint32_t>(2 * 3)};
+    buffer.clear();
+    vector_buffer_target::writer{&buffer}(histogram, Histogram_format);
+    vector_buffer_target::writer{&buffer}(std::uint8_t{42}, uint8_le);
+    {
+        auto reader = vector_buffer_target::reader{&buffer};
+        reader.skip(Histogram_format);
+        std::uint8_t last;
+        reader(last, uint8_le);
+        REQUIRE(last == 42);
+    }
+
+    // large values are skipped by seeking, small ones within the buffer
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    const std::string large(5 * 4096 + 3, 'x');
+    {
+        auto writer = file_descriptor_target::writer{fileno(file), std::size_t{4096}};
+        writer(large, string_format(uint32_le));
+        writer(std::string("small"), string_format(uint8_le));
+        writer(std::uint32_t{7}, uint32_le);
+        writer.flush();
+    }
+    ::lseek(fileno(file), 0, SEEK_SET);
+    {
+        auto reader = file_descriptor_target::reader{fileno(file), std::size_t{4096}};
+        reader.skip(string_format(uint32_le));
+        reader.skip(string_format(uint8_le));
+        std::uint32_t last;
+        reader(last, uint32_le);
+        REQUIRE(last == 7);
+    }
+    std::fclose(file);
+}
+
+TEST_CASE("record view") {
+    using generic_format::deserialization_exception;
+    using generic_format::mapping::record_range;
+    using generic_format::mapping::record_view;
+
+    // all offsets of fixed-size records are known at compile time
+    using packet_view = record_view<std::remove_cv_t<decltype(Packet_format)>>;
+    static_assert(packet_view::number_of_static_offsets == 4);
+    std::vector<std::byte> buffer;
+    vector_buffer_target::writer{&buffer}(Packet{1, 2, 3}, Packet_format);
+    packet_view packet{buffer.data(), buffer.size()};
+    REQUIRE(packet.offset<2>() == 8);
+    REQUIRE(packet.size() == 10);
+    REQUIRE(packet.get<2>() == 3);
+
+    // only the offset of the first dynamic field is known at compile time, the others are cached on access
+    using user_view = record_view<std::remove_cv_t<decltype(User_format)>>;
+    static_assert(user_view::number_of_static_offsets == 1);
+    buffer.clear();
+    {
+        auto writer = vector_buffer_target::writer{&buffer};
+        for (std::uint16_t i = 0; i < 100; ++i)
+            writer(User{"first", std::string(i, 'x'), {i, "street"}}, User_format);
+    }
+    std::size_t matches = 0, position = 0;
+    for (const auto& user : record_range{User_format, buffer.data(), buffer.size()}) {
+        REQUIRE(user.data() == buffer.data() + position);
+        REQUIRE(user.offset<1>() == 4 + 5);
+        REQUIRE(user.offset<2>() == 4 + 5 + 4 + user.get<1>().size());
+        if (user.get<2>().m_number % 10 == 0) {
+            REQUIRE(user.get<1>() == std::string(user.get<2>().m_number, 'x'));
+            User actual;
+            user.read(actual);
+            REQUIRE(actual == (User{"first", std::string(user.get<2>().m_number, 'x'), {user.get<2>().m_number, "street"}}));
+            ++matches;
+        }
+        position += user.size();
+    }
+    REQUIRE(matches == 10);
+    REQUIRE(position == buffer.size());
+
+    // fields beyond the end of the buffer cannot be accessed
+    record_view truncated{User_format, buffer.data(), 4 + 5 + 2};
+    REQUIRE(truncated.get<0>() == "first");
+    REQUIRE_THROWS_AS(truncated.get<1>(), deserialization_exception);
+    REQUIRE_THROWS_AS(truncated.size(), deserialization_exception);
+    REQUIRE_THROWS_AS((packet_view{buffer.data(), 9}.get<2>()), deserialization_exception);
+}
+
+TEST_CASE("file descriptor buffering") {
+    using generic_format::deserialization_exception;
+
+    // many small fixed-size writes, and blocks larger than the buffer
+    const std::size_t number_of_packets = 10000;
+    const std::string large(3 * 4096 + 17, 'x');
+
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    {
+        auto writer = file_descriptor_target::writer{fileno(file), std::size_t{4096}};
+        for (std::uint32_t i = 0; i < number_of_packets; ++i) {
+            writer(Packet{i, i + 1, static_cast<std::uint16_t>(i)}, Packet_format);
+            if (i % 1000 == 0)
+                writer(large, string_format(uint16_le));
+        }
+        writer.flush();
+    }
+    ::lseek(fileno(file), 0, SEEK_SET);
+    {
+        auto reader = file_descriptor_target::reader{fileno(file), std::size_t{4096}};
+        for (std::uint32_t i = 0; i < number_of_packets; ++i) {
+            Packet packet{};
+            reader(packet, Packet_format);
+            REQUIRE(packet == (Packet{i, i + 1, static_cast<std::uint16_t>(i)}));
+            if (i % 1000 == 0) {
+                std::string s;
+                reader(s, string_format(uint16_le));
+                REQUIRE(s == large);
+            }
+        }
+        Packet packet{};
+        REQUIRE_THROWS_AS(reader(packet, Packet_format), deserialization_exception);
+    }
+    std::fclose(file);
+}
+
+TEST_CASE("memory mapped file") {
+    using generic_format::deserialization_exception;
+
+    // small chunks and windows, such that the writer remaps and the reader advances its window several times
+    const std::size_t number_of_packets = 10000;
+    const std::string large(3 * 4096 + 17, 'x');
+    temporary_file    file;
+    {
+        auto writer = mmap_target::writer{file.name(), std::size_t{4096}};
+        for (std::uint32_t i = 0; i < number_of_packets; ++i) {
+            writer(Packet{i, i + 1, static_cast<std::uint16_t>(i)}, Packet_format);
+            if (i % 1000 == 0)
+                writer(large, string_format(uint16_le));
+        }
+    }
+    REQUIRE(file.size() == number_of_packets * 10 + 10 * (2 + large.size()));
+    {
+        auto reader = mmap_target::reader{file.name(), mmap_reader_options{true, 8192}};
+        for (std::uint32_t i = 0; i < number_of_packets; ++i) {
+            Packet packet{};
+            reader(packet, Packet_format);
+            REQUIRE(packet == (Packet{i, i + 1, static_cast<std::uint16_t>(i)}));
+            if (i % 1000 == 0) {
+                std::string s;
+                reader(s, string_format(uint16_le));
+                REQUIRE(s == large);
+            }
+        }
+        Packet packet{};
+        REQUIRE_THROWS_AS(reader(packet, Packet_format), deserialization_exception);
+    }
+}
+
+TEST_CASE("array view") {
+    using generic_format::deserialization_exception;
+    using generic_format::mapping::array_view;
+
+    using packet_view = array_view<std::remove_cv_t<decltype(Packet_format)>>;
+    static_assert(std::ranges::random_access_range<packet_view>);
+    static_assert(packet_view::stride == 10);
+
+    // packets sorted by source, such that they can be searched
+    const std::uint32_t    number_of_packets = 1000;
+    std::vector<std::byte> buffer;
+    {
+        auto writer = vector_buffer_target::writer{&buffer};
+        for (std::uint32_t i = 0; i < number_of_packets; ++i)
+            writer(Packet{2 * i, i, static_cast<std::uint16_t>(i)}, Packet_format);
+    }
+    array_view packets{Packet_format, buffer.data(), buffer.size()};
+    REQUIRE(packets.size() == number_of_packets);
+    REQUIRE(packets[17] == (Packet{34, 17, 17}));
+    REQUIRE(packets.begin()[999] == (Packet{1998, 999, 999}));
+    REQUIRE(packets.end() - packets.begin() == number_of_packets);
+    REQUIRE_THROWS_AS(packets.at(number_of_packets), deserialization_exception);
+
+    auto found = std::ranges::lower_bound(packets, 301u, {}, &Packet::m_source);
+    REQUIRE(found - packets.begin() == 151);
+    REQUIRE((*found).m_source == 302);
+
+    std::vector<Packet> decoded(10);
+    packets.read(number_of_packets - 10, decoded);
+    REQUIRE(decoded.front() == packets[number_of_packets - 10]);
+    REQUIRE(decoded.back() == packets[number_of_packets - 1]);
+    REQUIRE_THROWS_AS(packets.read(number_of_packets - 9, decoded), deserialization_exception);
+
+    // partitioned scans over subviews
+    std::uint64_t sum = 0;
+    for (std::size_t first = 0; first < number_of_packets; first += 300) {
+        auto partition = packets.subview(first, std::min<std::size_t>(300, number_of_packets - first));
+        for (const Packet& packet : partition)
+            sum += packet.m_target;
+    }
+    REQUIRE(sum == std::uint64_t{number_of_packets} * (number_of_packets - 1) / 2);
+    REQUIRE_THROWS_AS(packets.subview(1, number_of_packets), deserialization_exception);
+
+    // partial values at the end of the buffer are rejected
+    REQUIRE_THROWS_AS((packet_view{buffer.data(), buffer.size() - 1}), deserialization_exception);
+
+    // views of a memory mapped file, behind a header
+    temporary_file file;
+    {
+        auto writer = mmap_target::writer{file.name(), std::size_t{4096}};
+        writer(number_of_packets, uint32_le);
+        for (std::uint32_t i = 0; i < number_of_packets; ++i)
+            writer(Packet{2 * i, i, static_cast<std::uint16_t>(i)}, Packet_format);
+    }
+    {
+        auto          reader = mmap_target::reader{file.name()};
+        std::uint32_t count;
+        reader(count, uint32_le);
+        auto mapped = reader.view(count, Packet_format);
+        REQUIRE(mapped.size() == number_of_packets);
+        REQUIRE(std::equal(mapped.begin(), mapped.end(), packets.begin()));
+        REQUIRE_THROWS_AS(reader.view(1, Packet_format), deserialization_exception);
+    }
+}
@@ -8,13 +8,23 @@
 */
 #include "test_common.hpp"
 
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "generic_format/dsl.hpp"
+#include "generic_format/lookup/lookup.hpp"
 #include "generic_format/lookup/lookup_table.hpp"
+#include "generic_format/lookup/lookup_table_cache.hpp"
+#include "generic_format/primitives.hpp"
+#include "generic_format/targets/bounded_memory.hpp"
+#include "generic_format/targets/vector_buffer.hpp"
 
 using namespace std;
 using namespace generic_format::lookup;
+using namespace generic_format::targets::bounded_memory;
+using namespace generic_format::targets::vector_buffer;
 
 TEST_CASE("population") {
     lookup_table_builder<uint, string> builder0(0, 2);
@@ -69,4 +79,326 @@ TEST_CASE("lookup") {
     REQUIRE(snapshot.values() == expected);
 }
 
-// TODO(sw) test that contiguity check is working
+TEST_CASE("lookup by id while growing") {
+    lookup_table<uint, string> table;
+    const auto&                first = table.lookup_by_id(table.lookup_by_value("0"));
+
+    static constexpr uint number_of_values = 100000;
+    atomic<uint>          published{1};
+    atomic<bool>          failed{false};
+    vector<thread>        readers;
+    for (uint r = 0; r < 4; ++r) {
+        readers.emplace_back([&table, &published, &failed, r] {
+            uint id = r;
+            for (uint n = published.load(); n < number_of_values; n = published.load()) {
+                id = (id * 7919 + 1) % n;
+                if (table.lookup_by_id(id) != to_string(id))
+                    failed = true;
+            }
+        });
+    }
+    for (uint i = 1; i < number_of_values; ++i) {
+        table.lookup_by_value(to_string(i));
+        published = i + 1;
+    }
+    for (auto& reader : readers)
+        reader.join();
+    REQUIRE(!failed);
+    // values are never moved
+    REQUIRE(&first == &table.lookup_by_id(0));
+    REQUIRE(table.lookup_by_value("12345") == 12345);
+}
+
+TEST_CASE("concurrent lookup by value") {
+    concurrent_lookup_table<uint, string> table;
+
+    static constexpr uint number_of_values = 20000;
+    vector<vector<uint>>  ids(4, vector<uint>(number_of_values));
+    vector<thread>        writers;
+    for (uint w = 0; w < ids.size(); ++w) {
+        writers.emplace_back([&table, &ids, w] {
+            // each writer interns all values, in a different order (the steps are coprime to number_of_values)
+            static constexpr uint steps[] = {1, 3, 7, 9};
+            for (uint i = 0; i < number_of_values; ++i) {
+                auto value    = (i * steps[w]) % number_of_values;
+                ids[w][value] = table.lookup_by_value(to_string(value));
+            }
+        });
+    }
+    for (auto& writer : writers)
+        writer.join();
+
+    vector<bool> used(number_of_values);
+    for (uint value = 0; value < number_of_values; ++value) {
+        auto id = ids[0][value];
+        for (const auto& other : ids)
+            REQUIRE(other[value] == id);
+        REQUIRE(id < number_of_values);
+        REQUIRE(!used[id]);
+        used[id] = true;
+        REQUIRE(table.lookup_by_id(id) == to_string(value));
+    }
+    REQUIRE(table.snapshot_from_id(0).values().size() == number_of_values);
+}
+
+TEST_CASE("lookup table cache") {
+    concurrent_lookup_table<uint, string> table;
+    REQUIRE(table.lookup_by_value("a") == 0);
+
+    // assertions are not thread-safe, so each thread only records its results
+    vector<thread>      threads;
+    vector<char>        correct(4); // not vector<bool>, whose elements share bytes
+    vector<std::size_t> hits(4), misses(4);
+    for (uint t = 0; t < 4; ++t) {
+        threads.emplace_back([&table, &correct, &hits, &misses, t] {
+            lookup_table_cache<concurrent_lookup_table<uint, string>> cache(table, 100);
+            correct[t] = cache.capacity() == 128;
+            for (int round = 0; round < 10; ++round) {
+                correct[t] = correct[t] && cache.lookup_by_value("a") == 0;
+                correct[t] = correct[t] && cache.lookup_by_id(cache.lookup_by_value("b")) == "b";
+            }
+            hits[t]   = cache.hits();
+            misses[t] = cache.misses();
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (uint t = 0; t < 4; ++t) {
+        REQUIRE(correct[t]);
+        REQUIRE(misses[t] <= 2); // a single miss per value, unless "a" and "b" share a slot
+        REQUIRE(hits[t] + misses[t] == 20);
+    }
+    REQUIRE(table.lookup_by_value("b") == 1);
+
+    // bounded: a single slot keeps only the last value
+    lookup_table_cache<concurrent_lookup_table<uint, string>> cache(table, 1);
+    cache.lookup_by_value("a");
+    cache.lookup_by_value("b");
+    cache.lookup_by_value("a");
+    REQUIRE(cache.hits() == 0);
+    REQUIRE(cache.misses() == 3);
+    cache.lookup_by_value("a");
+    REQUIRE(cache.hits() == 1);
+}
+
+template <class Table>
+static void check_batch_lookup() {
+    Table table;
+    table.lookup_by_value("known");
+    vector<string> values{"a", "known", "b", "a", "c", "known"};
+    vector<uint>   ids(values.size());
+    table.lookup_by_values(values, ids);
+    // new values get ids in order of appearance
+    REQUIRE(ids == vector<uint>{1, 0, 2, 1, 3, 0});
+
+    vector<const string*> found(ids.size());
+    table.lookup_by_ids(ids, found);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        REQUIRE(*found[i] == values[i]);
+}
+
+TEST_CASE("batch lookup") {
+    check_batch_lookup<lookup_table<uint, string>>();
+    check_batch_lookup<concurrent_lookup_table<uint, string>>();
+}
+
+TEST_CASE("batch lookup table cache") {
+    concurrent_lookup_table<uint, string>                     table;
+    lookup_table_cache<concurrent_lookup_table<uint, string>> cache(table, 1024);
+    vector<string>                                            values;
+    for (int i = 0; i < 1000; ++i)
+        values.push_back(to_string(i % 10));
+    vector<uint> ids(values.size());
+    cache.lookup_by_values(values, ids);
+    cache.lookup_by_values(values, ids);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        REQUIRE(ids[i] == i % 10);
+    REQUIRE(cache.hits() + cache.misses() == 2000);
+    // misses only in the first batch
+    REQUIRE(cache.misses() <= 1000);
+    REQUIRE(cache.hits() >= 1000);
+}
+
+static string url(uint i) {
+    return "https://example.com/" + to_string(i * 2654435761u) + (i % 3 == 0 ? "/index.html" : "");
+}
+
+TEST_CASE("frozen lookup table") {
+    static constexpr uint      number_of_values = 50000;
+    lookup_table<uint, string> table;
+    for (uint i = 0; i < number_of_values; ++i)
+        table.lookup_by_value(url(i));
+    auto frozen = table.freeze();
+    REQUIRE(frozen.size() == number_of_values);
+    for (uint i = 0; i < number_of_values; ++i) {
+        REQUIRE(frozen.lookup_by_value(url(i)) == i);
+        REQUIRE(frozen.lookup_by_id(i) == url(i));
+    }
+    REQUIRE(!frozen.lookup_by_value("https://example.com/"));
+    REQUIRE(!frozen.lookup_by_value(""));
+
+    frozen_lookup_table<uint, string> empty;
+    REQUIRE(empty.size() == 0);
+    REQUIRE(!empty.lookup_by_value("a"));
+
+    vector<uint16_t>                    numbers{7, 0, 65535, 42};
+    frozen_lookup_table<uint8_t, uint16_t> frozen_numbers(numbers);
+    for (uint8_t i = 0; i < numbers.size(); ++i) {
+        REQUIRE(frozen_numbers.lookup_by_value(numbers[i]) == i);
+        REQUIRE(frozen_numbers.lookup_by_id(i) == numbers[i]);
+    }
+    REQUIRE(!frozen_numbers.lookup_by_value(8));
+}
+
+TEST_CASE("frozen lookup table with duplicated values") {
+    // duplicated values keep their last id, as in lookup_table
+    frozen_lookup_table<uint, string> frozen(vector<string>{"a", "b", "a"});
+    REQUIRE(frozen.size() == 3);
+    REQUIRE(frozen.lookup_by_value("a") == 2u);
+    REQUIRE(frozen.lookup_by_value("b") == 1u);
+    REQUIRE(frozen.lookup_by_id(0) == "a");
+
+    lookup_table_builder<uint, string> builder0(0, 2);
+    builder0.push_back("x");
+    builder0.push_back("y");
+    lookup_table_builder<uint, string> builder1(2, 2);
+    builder1.push_back("y");
+    builder1.push_back("z");
+    vector<lookup_table_builder<uint, string>> builders{builder0, builder1};
+    lookup_table<uint, string>                 table(builders.begin(), builders.end());
+    auto                                       frozen_table = table.freeze();
+    REQUIRE(frozen_table.size() == 4);
+    for (auto value : {"x", "y", "z"})
+        REQUIRE(frozen_table.lookup_by_value(value) == table.lookup_by_value(value));
+}
+
+template <class Format>
+static frozen_lookup_table<uint, string> check_frozen_storage(const vector<std::byte>& buffer, std::size_t offset, Format format) {
+    frozen_lookup_table<uint, string> actual;
+    bounded_memory_target::reader{buffer.data() + offset, buffer.size() - offset}(actual, format);
+    for (uint i = 0; i < 1000; ++i)
+        REQUIRE(actual.lookup_by_value(url(i)) == i);
+    return actual;
+}
+
+TEST_CASE("frozen lookup table storage") {
+    vector<string> values;
+    for (uint i = 0; i < 1000; ++i)
+        values.push_back(url(i));
+    frozen_lookup_table<uint, string> frozen(values);
+
+    static constexpr auto format      = generic_format::dsl::frozen_lookup_table_format<uint, string>();
+    static constexpr auto view_format = generic_format::dsl::frozen_lookup_table_view_format<uint, string>();
+    // the vector is aligned, a leading byte misaligns the table
+    vector<std::byte> buffer;
+    vector_buffer_target::writer{&buffer}(frozen, format);
+    REQUIRE(generic_format::targets::measure(frozen, format) == buffer.size());
+    vector<std::byte> misaligned{std::byte{0}};
+    misaligned.insert(misaligned.end(), buffer.begin(), buffer.end());
+
+    REQUIRE(!check_frozen_storage(buffer, 0, format).is_borrowed());
+    REQUIRE(check_frozen_storage(buffer, 0, view_format).is_borrowed());
+    REQUIRE(!check_frozen_storage(misaligned, 1, view_format).is_borrowed());
+
+    // ids out of range
+    auto corrupted = buffer;
+    for (std::size_t i = 8 + 32 + 1001 * 8; i < 8 + 32 + 1001 * 8 + 1000 * 4; ++i)
+        corrupted[i] = std::byte{0xff};
+    frozen_lookup_table<uint, string> actual;
+    REQUIRE_THROWS_AS(vector_buffer_target::reader{&corrupted}(actual, format), generic_format::deserialization_exception);
+    // truncated
+    corrupted.assign(buffer.begin(), buffer.end() - 1);
+    REQUIRE_THROWS_AS(vector_buffer_target::reader{&corrupted}(actual, view_format), generic_format::deserialization_exception);
+}
+
+TEST_CASE("lookup table deltas") {
+    using namespace generic_format::primitives;
+    using table_type                   = lookup_table<uint16_t, string>;
+    static constexpr auto delta_format = generic_format::dsl::lookup_table_delta_format(
+        lookup_type(uint16_le, generic_format::dsl::string_format(uint8_le)));
+
+    table_type                     written;
+    lookup_table_delta<table_type> written_delta{written};
+    vector<vector<std::byte>>      segments(3);
+
+    written.lookup_by_value("a");
+    written.lookup_by_value("b");
+    vector_buffer_target::writer{&segments[0]}(written_delta, delta_format);
+    REQUIRE(written_delta.next_id() == 2);
+    written.lookup_by_value("a");
+    written.lookup_by_value("c");
+    // measuring does not advance the delta
+    REQUIRE(generic_format::targets::measure(written_delta, delta_format) == 2 + 1 + (1 + 1));
+    REQUIRE(written_delta.next_id() == 2);
+    vector_buffer_target::writer{&segments[1]}(written_delta, delta_format);
+    vector_buffer_target::writer{&segments[2]}(written_delta, delta_format);
+    // only the new values: first id, count, and strings
+    REQUIRE(segments[1].size() == 2 + 1 + (1 + 1));
+    REQUIRE(segments[2].size() == 2 + 1);
+
+    table_type                     read;
+    lookup_table_delta<table_type> read_delta{read};
+    const auto&                    first = read.lookup_by_id(read.lookup_by_value("a"));
+    // segments must be applied in order
+    REQUIRE_THROWS_AS(vector_buffer_target::reader{&segments[1]}(read_delta, delta_format), generic_format::deserialization_exception);
+    for (const auto& segment : segments)
+        vector_buffer_target::reader{&segment}(read_delta, delta_format);
+    REQUIRE(read.size() == 3);
+    REQUIRE(read.snapshot_from_id(0).values() == vector<string>{"a", "b", "c"});
+    // existing values are not copied
+    REQUIRE(&first == &read.lookup_by_id(0));
+
+    // a delta which contradicts the table
+    table_type                     other;
+    lookup_table_delta<table_type> other_delta{other};
+    other.lookup_by_value("b");
+    REQUIRE_THROWS_AS(vector_buffer_target::reader{&segments[0]}(other_delta, delta_format), generic_format::deserialization_exception);
+}
+
+TEST_CASE("population contiguity") {
+    using builder_type = lookup_table_builder<uint, string>;
+    auto builder       = [](uint initial_id, vector<string> values) {
+        builder_type b(initial_id, values.size());
+        for (const auto& value : values)
+            b.push_back(value);
+        return b;
+    };
+    using table_type = lookup_table<uint, string>;
+
+    vector<builder_type> gap{builder(0, {"0", "1"}), builder(3, {"3"})};
+    REQUIRE_THROWS_AS(table_type(gap.begin(), gap.end()), generic_format::deserialization_exception);
+
+    vector<builder_type> overlap{builder(0, {"0", "1"}), builder(1, {"1", "2"})};
+    REQUIRE_THROWS_AS(table_type(overlap.begin(), overlap.end(), 4), generic_format::deserialization_exception);
+
+    vector<builder_type> not_from_zero{builder(1, {"1"})};
+    REQUIRE_THROWS_AS(table_type(not_from_zero.begin(), not_from_zero.end()), generic_format::deserialization_exception);
+
+    vector<builder_type> none;
+    REQUIRE(table_type(none.begin(), none.end()).size() == 0);
+}
+
+TEST_CASE("parallel population") {
+    constexpr uint                           builder_size = 1000;
+    vector<lookup_table_builder<uint, uint>> builders;
+    for (uint b = 50; b-- > 0;) { // out of order
+        builders.emplace_back(b * builder_size, builder_size);
+        for (uint i = 0; i < builder_size; ++i)
+            builders.back().push_back((b * builder_size + i) * 7);
+    }
+    const auto check = [&](auto& table) {
+        REQUIRE(table.size() == builders.size() * builder_size);
+        for (uint id = 0; id < table.size(); ++id) {
+            REQUIRE(table.lookup_by_id(id) == id * 7);
+            REQUIRE(table.lookup_by_value(id * 7) == id);
+        }
+        REQUIRE(table.lookup_by_value(1) == builders.size() * builder_size); // new values continue after the merged ones
+    };
+
+    lookup_table<uint, uint> sequential(builders.begin(), builders.end());
+    check(sequential);
+    lookup_table<uint, uint> parallel(builders.begin(), builders.end(), 4);
+    check(parallel);
+    concurrent_lookup_table<uint, uint> sharded(builders.begin(), builders.end(), 0);
+    check(sharded);
+}